@@ -1,8 +1,10 @@
 ﻿#pragma once
 
+#include <cstdint>
 #include <vector>
 
 #include "base/status_or.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "geometry/interval.hpp"
 #include "geometry/named_quantities.hpp"
 #include "physics/body.hpp"
@@ -17,6 +19,7 @@ namespace internal_orbital_elements {
 
 using base::Status;
 using base::StatusOr;
+using base::WorkStealingThreadPool;
 using geometry::Instant;
 using geometry::Interval;
 using physics::Body;
@@ -37,11 +40,16 @@ class OrbitalElements {
   OrbitalElements& operator=(OrbitalElements const&) = delete;
   OrbitalElements& operator=(OrbitalElements&&) = default;
 
+  // The computations that are independent for each point of |trajectory| or
+  // for each revolution are parallelized on |thread_pool| if it is not null.
+  // The result doesn't depend on the parallelism.  If called on a stoppable
+  // thread, returns CANCELLED soon after that thread is stopped.
   template<typename PrimaryCentred>
   static StatusOr<OrbitalElements> ForTrajectory(
       DiscreteTrajectory<PrimaryCentred> const& trajectory,
       MassiveBody const& primary,
-      Body const& secondary);
+      Body const& secondary,
+      WorkStealingThreadPool* thread_pool = nullptr);
 
   // The classical Keplerian elements (a, e, i, Ω, ω, M),
   // together with an epoch.
@@ -146,15 +154,35 @@ class OrbitalElements {
  private:
   OrbitalElements() = default;
 
+  // The number of consecutive indices processed by a call of |ParallelFor|
+  // between checks for a stop request.
+  static constexpr std::int64_t block_size = 256;
+
+  // Calls |function(i)| for each |i| in [begin, end[, in parallel on
+  // |thread_pool| if it is not null, sequentially otherwise.  The threads of
+  // the pool are not stoppable, so the stop token of the current thread is
+  // checked before each block of indices; once it is stopped, the remaining
+  // blocks are skipped and this function returns CANCELLED.
+  template<typename Function>
+  static Status ParallelFor(WorkStealingThreadPool* thread_pool,
+                            std::int64_t begin,
+                            std::int64_t end,
+                            Function const& function);
+
   template<typename PrimaryCentred>
-  static std::vector<EquinoctialElements> OsculatingEquinoctialElements(
-      DiscreteTrajectory<PrimaryCentred> const& trajectory,
+  static StatusOr<std::vector<EquinoctialElements>>
+  OsculatingEquinoctialElements(
+      std::vector<typename DiscreteTrajectory<PrimaryCentred>::Iterator::
+                      reference> const& points,
       MassiveBody const& primary,
-      Body const& secondary);
+      Body const& secondary,
+      WorkStealingThreadPool* thread_pool);
 
   template<typename PrimaryCentred>
-  static std::vector<Length> RadialDistances(
-      DiscreteTrajectory<PrimaryCentred> const& trajectory);
+  static StatusOr<std::vector<Length>> RadialDistances(
+      std::vector<typename DiscreteTrajectory<PrimaryCentred>::Iterator::
+                      reference> const& points,
+      WorkStealingThreadPool* thread_pool);
 
   // |equinoctial_elements| must contain at least 2 elements.
   static StatusOr<Time> SiderealPeriod(
@@ -165,10 +193,12 @@ class OrbitalElements {
   // their |EquinoctialElements::t|.
   static StatusOr<std::vector<EquinoctialElements>> MeanEquinoctialElements(
       std::vector<EquinoctialElements> const& osculating,
-      Time const& period);
+      Time const& period,
+      WorkStealingThreadPool* thread_pool);
 
   static StatusOr<std::vector<ClassicalElements>> ToClassicalElements(
-      std::vector<EquinoctialElements> const& equinoctial_elements);
+      std::vector<EquinoctialElements> const& equinoctial_elements,
+      WorkStealingThreadPool* thread_pool);
 
   // |mean_classical_elements_| must have been computed; sets
   // |anomalistic_period_|, |nodal_period_|, and |nodal_precession_|
@@ -35,15 +35,29 @@ template<typename PrimaryCentred>
 StatusOr<OrbitalElements> OrbitalElements::ForTrajectory(
     DiscreteTrajectory<PrimaryCentred> const& trajectory,
     MassiveBody const& primary,
-    Body const& secondary) {
+    Body const& secondary,
+    WorkStealingThreadPool* const thread_pool) {
   OrbitalElements orbital_elements;
   if (trajectory.Size() < 2) {
     return Status(Error::INVALID_ARGUMENT,
                   "trajectory.Size() is " + std::to_string(trajectory.Size()));
   }
+  // The points are gathered so that they may be accessed by index.
+  std::vector<typename DiscreteTrajectory<PrimaryCentred>::Iterator::reference>
+      points;
+  points.reserve(trajectory.Size());
+  for (auto const point : trajectory) {
+    points.push_back(point);
+  }
+  auto osculating_equinoctial_elements =
+      OsculatingEquinoctialElements<PrimaryCentred>(
+          points, primary, secondary, thread_pool);
+  RETURN_IF_ERROR(osculating_equinoctial_elements);
   orbital_elements.osculating_equinoctial_elements_ =
-      OsculatingEquinoctialElements(trajectory, primary, secondary);
-  orbital_elements.radial_distances_ = RadialDistances(trajectory);
+      std::move(osculating_equinoctial_elements).ValueOrDie();
+  auto radial_distances = RadialDistances<PrimaryCentred>(points, thread_pool);
+  RETURN_IF_ERROR(radial_distances);
+  orbital_elements.radial_distances_ = std::move(radial_distances).ValueOrDie();
   auto const sidereal_period =
       SiderealPeriod(orbital_elements.osculating_equinoctial_elements_);
   RETURN_IF_ERROR(sidereal_period);
@@ -58,7 +72,8 @@ StatusOr<OrbitalElements> OrbitalElements::ForTrajectory(
   }
   auto mean_equinoctial_elements =
       MeanEquinoctialElements(orbital_elements.osculating_equinoctial_elements_,
-                              orbital_elements.sidereal_period_);
+                              orbital_elements.sidereal_period_,
+                              thread_pool);
   RETURN_IF_ERROR(mean_equinoctial_elements);
   orbital_elements.mean_equinoctial_elements_ =
       std::move(mean_equinoctial_elements).ValueOrDie();
@@ -72,7 +87,8 @@ StatusOr<OrbitalElements> OrbitalElements::ForTrajectory(
                         trajectory.front().time));
   }
   auto mean_classical_elements =
-      ToClassicalElements(orbital_elements.mean_equinoctial_elements_);
+      ToClassicalElements(orbital_elements.mean_equinoctial_elements_,
+                          thread_pool);
   RETURN_IF_ERROR(mean_classical_elements);
   orbital_elements.mean_classical_elements_ =
       std::move(mean_classical_elements).ValueOrDie();
@@ -138,54 +154,99 @@ inline Interval<Length> OrbitalElements::radial_distance_interval() const {
   return radial_distance_interval_;
 }
 
+template<typename Function>
+Status OrbitalElements::ParallelFor(WorkStealingThreadPool* const thread_pool,
+                                    std::int64_t const begin,
+                                    std::int64_t const end,
+                                    Function const& function) {
+  auto const stop = this_stoppable_thread::get_stop_token();
+  std::int64_t const number_of_blocks =
+      (end - begin + block_size - 1) / block_size;
+  auto const process_block = [begin, end, &function, &stop](
+                                 std::int64_t const block) {
+    if (stop.stop_requested()) {
+      return;
+    }
+    std::int64_t const block_begin = begin + block * block_size;
+    std::int64_t const block_end = std::min(end, block_begin + block_size);
+    for (std::int64_t i = block_begin; i < block_end; ++i) {
+      function(i);
+    }
+  };
+  if (thread_pool == nullptr) {
+    for (std::int64_t block = 0; block < number_of_blocks; ++block) {
+      process_block(block);
+    }
+  } else {
+    thread_pool->ParallelFor(0, number_of_blocks, process_block);
+  }
+  RETURN_IF_STOPPED;
+  return Status::OK;
+}
+
 template<typename PrimaryCentred>
-std::vector<OrbitalElements::EquinoctialElements>
+StatusOr<std::vector<OrbitalElements::EquinoctialElements>>
 OrbitalElements::OsculatingEquinoctialElements(
-    DiscreteTrajectory<PrimaryCentred> const& trajectory,
+    std::vector<typename DiscreteTrajectory<PrimaryCentred>::Iterator::
+                    reference> const& points,
     MassiveBody const& primary,
-    Body const& secondary) {
+    Body const& secondary,
+    WorkStealingThreadPool* const thread_pool) {
   DegreesOfFreedom<PrimaryCentred> const primary_dof{
       PrimaryCentred::origin, PrimaryCentred::unmoving};
-  std::vector<EquinoctialElements> result;
-  for (auto const& [time, degrees_of_freedom] : trajectory) {
-    auto const osculating_elements =
-        KeplerOrbit<PrimaryCentred>(primary,
-                                    secondary,
-                                    degrees_of_freedom - primary_dof,
-                                    time)
-            .elements_at_epoch();
-    double const& e = *osculating_elements.eccentricity;
-    Angle const& ϖ = *osculating_elements.longitude_of_periapsis;
-    Angle const& Ω = osculating_elements.longitude_of_ascending_node;
-    Angle const& M = *osculating_elements.mean_anomaly;
-    Angle const& i = osculating_elements.inclination;
-    double const tg_½i = Tan(i / 2);
-    double const cotg_½i = 1 / tg_½i;
-    result.push_back(
-        {.t = time,
-         .a = *osculating_elements.semimajor_axis,
-         .h = e * Sin(ϖ),
-         .k = e * Cos(ϖ),
-         .λ = result.empty() ? ϖ + M : UnwindFrom(result.back().λ, ϖ + M),
-         .p = tg_½i * Sin(Ω),
-         .q = tg_½i * Cos(Ω),
-         .pʹ = cotg_½i * Sin(Ω),
-         .qʹ = cotg_½i * Cos(Ω)});
+  std::vector<EquinoctialElements> result(points.size());
+  RETURN_IF_ERROR(ParallelFor(
+      thread_pool,
+      0, points.size(),
+      [&points, &primary, &primary_dof, &result, &secondary](
+          std::int64_t const n) {
+        auto const& [time, degrees_of_freedom] = points[n];
+        auto const osculating_elements =
+            KeplerOrbit<PrimaryCentred>(primary,
+                                        secondary,
+                                        degrees_of_freedom - primary_dof,
+                                        time)
+                .elements_at_epoch();
+        double const& e = *osculating_elements.eccentricity;
+        Angle const& ϖ = *osculating_elements.longitude_of_periapsis;
+        Angle const& Ω = osculating_elements.longitude_of_ascending_node;
+        Angle const& M = *osculating_elements.mean_anomaly;
+        Angle const& i = osculating_elements.inclination;
+        double const tg_½i = Tan(i / 2);
+        double const cotg_½i = 1 / tg_½i;
+        result[n] = {.t = time,
+                     .a = *osculating_elements.semimajor_axis,
+                     .h = e * Sin(ϖ),
+                     .k = e * Cos(ϖ),
+                     .λ = ϖ + M,
+                     .p = tg_½i * Sin(Ω),
+                     .q = tg_½i * Cos(Ω),
+                     .pʹ = cotg_½i * Sin(Ω),
+                     .qʹ = cotg_½i * Cos(Ω)};
+      }));
+  // Each value of the mean longitude is unwound from the previous one, so this
+  // pass is sequential.
+  for (std::int64_t i = 1; i < result.size(); ++i) {
+    result[i].λ = UnwindFrom(result[i - 1].λ, result[i].λ);
   }
   return result;
 }
 
 template<typename PrimaryCentred>
-std::vector<Length> OrbitalElements::RadialDistances(
-    DiscreteTrajectory<PrimaryCentred> const& trajectory) {
-  std::vector<Length> radial_distances;
-  radial_distances.reserve(trajectory.Size());
+StatusOr<std::vector<Length>> OrbitalElements::RadialDistances(
+    std::vector<typename DiscreteTrajectory<PrimaryCentred>::Iterator::
+                    reference> const& points,
+    WorkStealingThreadPool* const thread_pool) {
+  std::vector<Length> radial_distances(points.size());
   DegreesOfFreedom<PrimaryCentred> const primary_dof{PrimaryCentred::origin,
                                                      PrimaryCentred::unmoving};
-  for (auto const& [time, degrees_of_freedom] : trajectory) {
-    radial_distances.push_back(
-        (degrees_of_freedom.position() - primary_dof.position()).Norm());
-  }
+  RETURN_IF_ERROR(ParallelFor(
+      thread_pool,
+      0, points.size(),
+      [&points, &primary_dof, &radial_distances](std::int64_t const i) {
+        radial_distances[i] = (points[i].degrees_of_freedom.position() -
+                               primary_dof.position()).Norm();
+      }));
   return radial_distances;
 }
 
@@ -225,7 +286,8 @@ inline StatusOr<Time> OrbitalElements::SiderealPeriod(
 inline StatusOr<std::vector<OrbitalElements::EquinoctialElements>>
 OrbitalElements::MeanEquinoctialElements(
     std::vector<EquinoctialElements> const& osculating,
-    Time const& period) {
+    Time const& period,
+    WorkStealingThreadPool* const thread_pool) {
   Instant const& t_min = osculating.front().t;
   // This function averages the elements in |osculating| over |period|.
   // For each |EquinoctialElements osculating_elements = osculating[i]| in
@@ -276,97 +338,126 @@ OrbitalElements::MeanEquinoctialElements(
     integrals.back().ʃ_qʹ_dt += (it->qʹ + previous->qʹ) / 2 * dt;
   }
 
-  // Now compute the averages.
-  std::vector<EquinoctialElements> mean_elements;
-  int j = 0;
-  for (auto const& up_to_tᵢ : integrals) {
-    RETURN_IF_STOPPED;
-    // We are averaging the elements over the interval [tᵢ, tᵢ + period].
-    Instant const tᵢ = up_to_tᵢ.t_max;
-    while (integrals[j].t_max < tᵢ + period) {
-      if (++j == integrals.size()) {
-        return mean_elements;
-      }
-    }
-    // We have tⱼ₋₁ < tᵢ + period ≤ tⱼ.
-    auto const& tⱼ = osculating[j].t;
-    auto const& tⱼ₋₁ = osculating[j - 1].t;
-
-    auto const& up_to_tⱼ₋₁ = integrals[j - 1];
-    // |element| should be a pointer to a member of |EquinoctialElements|;
-    // Integrates that element on [tⱼ₋₁, tᵢ + period].
-    auto ʃ = [j, &period, &tᵢ, &tⱼ, &tⱼ₋₁, &osculating](auto element) {
-      Time const Δt = tⱼ - tⱼ₋₁;
-      Time const dt = tᵢ + period - tⱼ₋₁;
-      auto const element_at_end =
-          osculating[j - 1].*element +
-          (osculating[j].*element - osculating[j - 1].*element) * (dt / Δt);
-      return (osculating[j - 1].*element + element_at_end) / 2 * dt;
-    };
-    mean_elements.emplace_back();
-    mean_elements.back().t = tᵢ + period / 2;
-    mean_elements.back().a =
-        (up_to_tⱼ₋₁.ʃ_a_dt - up_to_tᵢ.ʃ_a_dt + ʃ(&EquinoctialElements::a)) /
-        period;
-    mean_elements.back().h =
-        (up_to_tⱼ₋₁.ʃ_h_dt - up_to_tᵢ.ʃ_h_dt + ʃ(&EquinoctialElements::h)) /
-        period;
-    mean_elements.back().k =
-        (up_to_tⱼ₋₁.ʃ_k_dt - up_to_tᵢ.ʃ_k_dt + ʃ(&EquinoctialElements::k)) /
-        period;
-    mean_elements.back().λ =
-        (up_to_tⱼ₋₁.ʃ_λ_dt - up_to_tᵢ.ʃ_λ_dt + ʃ(&EquinoctialElements::λ)) /
-        period;
-    mean_elements.back().p =
-        (up_to_tⱼ₋₁.ʃ_p_dt - up_to_tᵢ.ʃ_p_dt + ʃ(&EquinoctialElements::p)) /
-        period;
-    mean_elements.back().q =
-        (up_to_tⱼ₋₁.ʃ_q_dt - up_to_tᵢ.ʃ_q_dt + ʃ(&EquinoctialElements::q)) /
-        period;
-    mean_elements.back().pʹ =
-        (up_to_tⱼ₋₁.ʃ_pʹ_dt - up_to_tᵢ.ʃ_pʹ_dt + ʃ(&EquinoctialElements::pʹ)) /
-        period;
-    mean_elements.back().qʹ =
-        (up_to_tⱼ₋₁.ʃ_qʹ_dt - up_to_tᵢ.ʃ_qʹ_dt + ʃ(&EquinoctialElements::qʹ)) /
-        period;
-  }
+  // Now compute the averages.  There is one for each |tᵢ| such that
+  // |tᵢ + period| is within the trajectory, and they are independent.
+  Instant const& t_max = integrals.back().t_max;
+  std::int64_t const number_of_mean_elements =
+      std::partition_point(integrals.begin(),
+                           integrals.end(),
+                           [&period, &t_max](
+                               IntegratedEquinoctialElements const& up_to_tᵢ) {
+                             return up_to_tᵢ.t_max + period <= t_max;
+                           }) -
+      integrals.begin();
+  std::vector<EquinoctialElements> mean_elements(number_of_mean_elements);
+  RETURN_IF_ERROR(ParallelFor(
+      thread_pool,
+      0, number_of_mean_elements,
+      [&integrals, &mean_elements, &osculating, &period](std::int64_t const i) {
+        auto const& up_to_tᵢ = integrals[i];
+        // We are averaging the elements over the interval [tᵢ, tᵢ + period].
+        Instant const tᵢ = up_to_tᵢ.t_max;
+        auto const ends_before =
+            [](IntegratedEquinoctialElements const& up_to_t, Instant const& t) {
+              return up_to_t.t_max < t;
+            };
+        int const j = std::lower_bound(integrals.begin() + i,
+                                       integrals.end(),
+                                       tᵢ + period,
+                                       ends_before) -
+                      integrals.begin();
+        // We have tⱼ₋₁ < tᵢ + period ≤ tⱼ.
+        auto const& tⱼ = osculating[j].t;
+        auto const& tⱼ₋₁ = osculating[j - 1].t;
+
+        auto const& up_to_tⱼ₋₁ = integrals[j - 1];
+        // |element| should be a pointer to a member of |EquinoctialElements|;
+        // Integrates that element on [tⱼ₋₁, tᵢ + period].
+        auto ʃ = [j, &period, &tᵢ, &tⱼ, &tⱼ₋₁, &osculating](auto element) {
+          Time const Δt = tⱼ - tⱼ₋₁;
+          Time const dt = tᵢ + period - tⱼ₋₁;
+          auto const element_at_end =
+              osculating[j - 1].*element +
+              (osculating[j].*element - osculating[j - 1].*element) *
+                  (dt / Δt);
+          return (osculating[j - 1].*element + element_at_end) / 2 * dt;
+        };
+        EquinoctialElements& mean = mean_elements[i];
+        mean.t = tᵢ + period / 2;
+        mean.a = (up_to_tⱼ₋₁.ʃ_a_dt - up_to_tᵢ.ʃ_a_dt +
+                  ʃ(&EquinoctialElements::a)) / period;
+        mean.h = (up_to_tⱼ₋₁.ʃ_h_dt - up_to_tᵢ.ʃ_h_dt +
+                  ʃ(&EquinoctialElements::h)) / period;
+        mean.k = (up_to_tⱼ₋₁.ʃ_k_dt - up_to_tᵢ.ʃ_k_dt +
+                  ʃ(&EquinoctialElements::k)) / period;
+        mean.λ = (up_to_tⱼ₋₁.ʃ_λ_dt - up_to_tᵢ.ʃ_λ_dt +
+                  ʃ(&EquinoctialElements::λ)) / period;
+        mean.p = (up_to_tⱼ₋₁.ʃ_p_dt - up_to_tᵢ.ʃ_p_dt +
+                  ʃ(&EquinoctialElements::p)) / period;
+        mean.q = (up_to_tⱼ₋₁.ʃ_q_dt - up_to_tᵢ.ʃ_q_dt +
+                  ʃ(&EquinoctialElements::q)) / period;
+        mean.pʹ = (up_to_tⱼ₋₁.ʃ_pʹ_dt - up_to_tᵢ.ʃ_pʹ_dt +
+                   ʃ(&EquinoctialElements::pʹ)) / period;
+        mean.qʹ = (up_to_tⱼ₋₁.ʃ_qʹ_dt - up_to_tᵢ.ʃ_qʹ_dt +
+                   ʃ(&EquinoctialElements::qʹ)) / period;
+      }));
   return mean_elements;
 }
 
 inline StatusOr<std::vector<OrbitalElements::ClassicalElements>>
 OrbitalElements::ToClassicalElements(
-    std::vector<EquinoctialElements> const& equinoctial_elements) {
-  std::vector<ClassicalElements> classical_elements;
-  for (auto const& equinoctial : equinoctial_elements) {
-    RETURN_IF_STOPPED;
-    double const tg_½i = Sqrt(Pow<2>(equinoctial.p) + Pow<2>(equinoctial.q));
-    double const cotg_½i =
-        Sqrt(Pow<2>(equinoctial.pʹ) + Pow<2>(equinoctial.qʹ));
-    Angle const i =
-        cotg_½i > tg_½i ? 2 * ArcTan(tg_½i) : 2 * ArcTan(1 / cotg_½i);
-    Angle const Ω = cotg_½i > tg_½i ? ArcTan(equinoctial.p, equinoctial.q)
-                                    : ArcTan(equinoctial.pʹ, equinoctial.qʹ);
-    double const e = Sqrt(Pow<2>(equinoctial.h) + Pow<2>(equinoctial.k));
-    Angle const ϖ = ArcTan(equinoctial.h, equinoctial.k);
-    Angle const ω = ϖ - Ω;
-    Angle const M = equinoctial.λ - ϖ;
-    classical_elements.push_back(
-        {.time = equinoctial.t,
-         .semimajor_axis = equinoctial.a,
-         .eccentricity = e,
-         .inclination = i,
-         .longitude_of_ascending_node = classical_elements.empty()
-             ? Mod(Ω, 2 * π * Radian)
-             : UnwindFrom(classical_elements.back().longitude_of_ascending_node,
-                          Ω),
-         .argument_of_periapsis = classical_elements.empty()
-             ? Mod(ω, 2 * π * Radian)
-             : UnwindFrom(classical_elements.back().argument_of_periapsis, ω),
-         .mean_anomaly = classical_elements.empty()
-             ? Mod(M, 2 * π * Radian)
-             : UnwindFrom(classical_elements.back().mean_anomaly, M),
-         .periapsis_distance = (1 - e) * equinoctial.a,
-         .apoapsis_distance = (1 + e) * equinoctial.a});
+    std::vector<EquinoctialElements> const& equinoctial_elements,
+    WorkStealingThreadPool* const thread_pool) {
+  std::vector<ClassicalElements> classical_elements(
+      equinoctial_elements.size());
+  RETURN_IF_ERROR(ParallelFor(
+      thread_pool,
+      0, equinoctial_elements.size(),
+      [&classical_elements, &equinoctial_elements](std::int64_t const n) {
+        auto const& equinoctial = equinoctial_elements[n];
+        double const tg_½i =
+            Sqrt(Pow<2>(equinoctial.p) + Pow<2>(equinoctial.q));
+        double const cotg_½i =
+            Sqrt(Pow<2>(equinoctial.pʹ) + Pow<2>(equinoctial.qʹ));
+        Angle const i =
+            cotg_½i > tg_½i ? 2 * ArcTan(tg_½i) : 2 * ArcTan(1 / cotg_½i);
+        Angle const Ω = cotg_½i > tg_½i
+                            ? ArcTan(equinoctial.p, equinoctial.q)
+                            : ArcTan(equinoctial.pʹ, equinoctial.qʹ);
+        double const e = Sqrt(Pow<2>(equinoctial.h) + Pow<2>(equinoctial.k));
+        Angle const ϖ = ArcTan(equinoctial.h, equinoctial.k);
+        Angle const ω = ϖ - Ω;
+        Angle const M = equinoctial.λ - ϖ;
+        // The angles are unwound below.
+        classical_elements[n] = {.time = equinoctial.t,
+                                 .semimajor_axis = equinoctial.a,
+                                 .eccentricity = e,
+                                 .inclination = i,
+                                 .longitude_of_ascending_node = Ω,
+                                 .argument_of_periapsis = ω,
+                                 .mean_anomaly = M,
+                                 .periapsis_distance = (1 - e) * equinoctial.a,
+                                 .apoapsis_distance = (1 + e) * equinoctial.a};
+      }));
+  // Each angle is unwound from the previous one, so this pass is sequential.
+  for (std::int64_t n = 0; n < classical_elements.size(); ++n) {
+    ClassicalElements& elements = classical_elements[n];
+    if (n == 0) {
+      elements.longitude_of_ascending_node =
+          Mod(elements.longitude_of_ascending_node, 2 * π * Radian);
+      elements.argument_of_periapsis =
+          Mod(elements.argument_of_periapsis, 2 * π * Radian);
+      elements.mean_anomaly = Mod(elements.mean_anomaly, 2 * π * Radian);
+    } else {
+      ClassicalElements const& previous = classical_elements[n - 1];
+      elements.longitude_of_ascending_node =
+          UnwindFrom(previous.longitude_of_ascending_node,
+                     elements.longitude_of_ascending_node);
+      elements.argument_of_periapsis = UnwindFrom(
+          previous.argument_of_periapsis, elements.argument_of_periapsis);
+      elements.mean_anomaly =
+          UnwindFrom(previous.mean_anomaly, elements.mean_anomaly);
+    }
   }
   return classical_elements;
 }
@@ -25,6 +25,7 @@ namespace astronomy {
 using astronomy::J2000;
 using base::make_not_null_unique;
 using base::not_null;
+using base::WorkStealingThreadPool;
 using geometry::Instant;
 using geometry::Position;
 using geometry::Velocity;
@@ -220,6 +221,98 @@ TEST_F(OrbitalElementsTest, KeplerOrbit) {
              mathematica::ExpressIn(Metre, Second, Radian));
 }
 
+// The elements computed in parallel are identical to those computed
+// sequentially.
+TEST_F(OrbitalElementsTest, ThreadPool) {
+  SolarSystem<ICRS> solar_system(
+      SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+      SOLUTION_DIR / "astronomy" /
+          "sol_initial_state_jd_2451545_000000000.proto.txt");
+  std::vector<std::string> const names = solar_system.names();
+  for (auto const& name : names) {
+    if (name != "Earth") {
+      solar_system.RemoveMassiveBody(name);
+    }
+  }
+  solar_system.LimitOblatenessToDegree("Earth", 2);
+  solar_system.LimitOblatenessToZonal("Earth");
+  auto const ephemeris = solar_system.MakeEphemeris(
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Milli(Metre),
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<ICRS>::FixedStepParameters(
+          SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                             Position<ICRS>>(),
+          /*step=*/1 * JulianYear));
+  MassiveBody const& earth = *solar_system.massive_body(*ephemeris, "Earth");
+
+  KeplerianElements<GCRS> initial_osculating;
+  initial_osculating.semimajor_axis = 7000 * Kilo(Metre);
+  initial_osculating.eccentricity = 1e-2;
+  initial_osculating.inclination = 60 * Degree;
+  initial_osculating.longitude_of_ascending_node = 10 * Degree;
+  initial_osculating.argument_of_periapsis = 20 * Degree;
+  initial_osculating.mean_anomaly = 30 * Degree;
+  auto const trajectory = EarthCentredTrajectory(
+      initial_osculating, J2000, J2000 + 10 * Day, *ephemeris);
+
+  WorkStealingThreadPool thread_pool(/*pool_size=*/4);
+  auto const status_or_sequential_elements =
+      OrbitalElements::ForTrajectory(*trajectory, earth, MasslessBody{});
+  auto const status_or_parallel_elements = OrbitalElements::ForTrajectory(
+      *trajectory, earth, MasslessBody{}, &thread_pool);
+  ASSERT_THAT(status_or_sequential_elements, IsOk());
+  ASSERT_THAT(status_or_parallel_elements, IsOk());
+  OrbitalElements const& sequential_elements =
+      status_or_sequential_elements.ValueOrDie();
+  OrbitalElements const& parallel_elements =
+      status_or_parallel_elements.ValueOrDie();
+
+  auto const expect_equal = [](
+      std::vector<OrbitalElements::EquinoctialElements> const& expected,
+      std::vector<OrbitalElements::EquinoctialElements> const& actual) {
+    ASSERT_EQ(expected.size(), actual.size());
+    for (int i = 0; i < expected.size(); ++i) {
+      EXPECT_EQ(expected[i].t, actual[i].t) << i;
+      EXPECT_EQ(expected[i].a, actual[i].a) << i;
+      EXPECT_EQ(expected[i].h, actual[i].h) << i;
+      EXPECT_EQ(expected[i].k, actual[i].k) << i;
+      EXPECT_EQ(expected[i].λ, actual[i].λ) << i;
+      EXPECT_EQ(expected[i].p, actual[i].p) << i;
+      EXPECT_EQ(expected[i].q, actual[i].q) << i;
+      EXPECT_EQ(expected[i].pʹ, actual[i].pʹ) << i;
+      EXPECT_EQ(expected[i].qʹ, actual[i].qʹ) << i;
+    }
+  };
+  expect_equal(sequential_elements.osculating_equinoctial_elements(),
+               parallel_elements.osculating_equinoctial_elements());
+  expect_equal(sequential_elements.mean_equinoctial_elements(),
+               parallel_elements.mean_equinoctial_elements());
+
+  auto const& sequential_mean = sequential_elements.mean_elements();
+  auto const& parallel_mean = parallel_elements.mean_elements();
+  ASSERT_EQ(sequential_mean.size(), parallel_mean.size());
+  for (int i = 0; i < sequential_mean.size(); ++i) {
+    EXPECT_EQ(sequential_mean[i].longitude_of_ascending_node,
+              parallel_mean[i].longitude_of_ascending_node) << i;
+    EXPECT_EQ(sequential_mean[i].argument_of_periapsis,
+              parallel_mean[i].argument_of_periapsis) << i;
+    EXPECT_EQ(sequential_mean[i].mean_anomaly,
+              parallel_mean[i].mean_anomaly) << i;
+  }
+  EXPECT_EQ(sequential_elements.sidereal_period(),
+            parallel_elements.sidereal_period());
+  EXPECT_EQ(sequential_elements.nodal_period(),
+            parallel_elements.nodal_period());
+  EXPECT_EQ(sequential_elements.anomalistic_period(),
+            parallel_elements.anomalistic_period());
+  EXPECT_EQ(sequential_elements.nodal_precession(),
+            parallel_elements.nodal_precession());
+  EXPECT_EQ(sequential_elements.radial_distance_interval().min,
+            parallel_elements.radial_distance_interval().min);
+  EXPECT_EQ(sequential_elements.radial_distance_interval().max,
+            parallel_elements.radial_distance_interval().max);
+}
+
 TEST_F(OrbitalElementsTest, J2Perturbation) {
   // The satellite is under the influence of an Earth with a zonal geopotential
   // of degree 2 and no third bodies.
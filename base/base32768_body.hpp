@@ -3,6 +3,7 @@
 
 #include "base/base32768.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <cstdint>
@@ -14,6 +15,7 @@
 #include <vector>
 
 #include "base/bits.hpp"
+#include "base/encoding_kernels.hpp"
 #include "base/macros.hpp"
 #include "glog/logging.h"
 
@@ -38,6 +40,10 @@ class Repertoire {
 template<std::int64_t block_size, std::int64_t block_count>
 class CachingRepertoire : public Repertoire {
  public:
+  using Value = std::conditional_t<(FloorLog2(block_size * block_count) > 8),
+                                   std::uint16_t,
+                                   std::uint8_t>;
+
   constexpr std::int64_t EncodingBits() const;
 
   // Returns true if this repertoire is capable of encoding the given code
@@ -47,6 +53,11 @@ class CachingRepertoire : public Repertoire {
   char16_t Encode(std::uint16_t k) const override;
   std::uint16_t Decode(char16_t code_point) const override;
 
+  // The caches used by |Encode| and |Decode|, for use by the vectorized
+  // kernels.
+  char16_t const* EncodingTable() const;
+  Value const* DecodingTable() const;
+
  private:
   template<std::int64_t block_count_plus_1>
   constexpr CachingRepertoire(
@@ -58,12 +69,12 @@ class CachingRepertoire : public Repertoire {
   // These arrays are sparse: not all entries are filled with useful data.  The
   // caller must encode values which are within [0, block_count * block_size[,
   // and must decode characters which lie within the blocks of this repertoire.
-  std::array<char16_t, block_count * block_size> encoding_cache_;
+  // Each array has an extra entry at the end because the AVX2 gathers read 32
+  // bits for each 16-bit entry.  The decoding cache must also have an entry for
+  // U+FFFF.
+  std::array<char16_t, block_count * block_size + 1> encoding_cache_;
   // Using a C array because MSVC gets confused with an std::array.
-  std::conditional_t<(FloorLog2(block_size * block_count) > 8),
-                     std::uint16_t,
-                     std::uint8_t>
-      decoding_cache_[std::numeric_limits<char16_t>::max()];
+  Value decoding_cache_[std::numeric_limits<char16_t>::max() + 2];
 
   template<std::int64_t s, std::int64_t c>
   friend constexpr CachingRepertoire<s, c - 1> MakeRepertoire(
@@ -80,6 +91,7 @@ constexpr CachingRepertoire<block_size, block_count>::CachingRepertoire(
     char16_t const (&blocks)[block_count_plus_1])
     : blocks_(blocks),
       encoding_bits_(FloorLog2(block_size * block_count)),
+      encoding_cache_(),
       decoding_cache_() {
   // Don't do pointer arithmetic in this constructor, it confuses MSVC.
   static_assert(block_count_plus_1 == block_count + 1,
@@ -139,6 +151,18 @@ std::uint16_t CachingRepertoire<block_size, block_count>::Decode(
   return decoding_cache_[code_point];
 }
 
+template<std::int64_t block_size, std::int64_t block_count>
+char16_t const*
+CachingRepertoire<block_size, block_count>::EncodingTable() const {
+  return encoding_cache_.data();
+}
+
+template<std::int64_t block_size, std::int64_t block_count>
+auto CachingRepertoire<block_size, block_count>::DecodingTable() const
+    -> Value const* {
+  return decoding_cache_;
+}
+
 template<std::int64_t block_size, std::int64_t block_count_plus_1>
 constexpr CachingRepertoire<block_size, block_count_plus_1 - 1> MakeRepertoire(
     char16_t const (&blocks)[block_count_plus_1]) {
@@ -199,6 +223,10 @@ constexpr std::int64_t bytes_per_code_point =
     (bits_per_code_point + 2 * bits_per_byte - 2) / bits_per_byte;
 static_assert(bytes_per_code_point == 3,
               "End of input padding below won't be correct");
+// The number of bytes and code points in a group that starts and ends on a byte
+// boundary.
+constexpr std::int64_t bytes_per_group = bits_per_code_point;
+constexpr std::int64_t code_points_per_group = bits_per_byte;
 
 template<bool null_terminated>
 void Base32768Encoder<null_terminated>::Encode(Array<std::uint8_t const> input,
@@ -206,6 +234,14 @@ void Base32768Encoder<null_terminated>::Encode(Array<std::uint8_t const> input,
   CHECK_NOTNULL(input.data);
   CHECK(input.size == 0 || output.data != nullptr);
 
+  // The kernel encodes a prefix made of complete groups of 15 bytes, which
+  // leaves |input_bit_index| at 0.  We encode the rest.
+  std::int64_t const encoded_size = EncodeBase32768Prefix(
+      input.data, input.size, fifteen_bits.EncodingTable(), output.data);
+  input.data += encoded_size;
+  input.size -= encoded_size;
+  output.data += encoded_size / bytes_per_group * code_points_per_group;
+
   std::uint8_t const* const input_end = input.data + input.size;
   std::int64_t input_bit_index = 0;
   while (input.data < input_end) {
@@ -287,6 +323,21 @@ void Base32768Encoder<null_terminated>::Decode(Array<char16_t const> input,
   CHECK_NOTNULL(input.data);
   CHECK(input.size == 0 || output.data != nullptr);
 
+  // The kernel decodes a prefix made of complete groups of 8 code points, which
+  // leaves |output_bit_index| at 0.  It writes complete groups of 15 bytes, so
+  // we leave to the loop below the groups that would overflow the output, as
+  // well as the last code point, which may belong to |seven_bits|.
+  std::int64_t const decoded_size = DecodeBase32768Prefix(
+      input.data,
+      std::min(input.size - 1,
+               output.size / bytes_per_group * code_points_per_group),
+      fifteen_bits.DecodingTable(),
+      output.data);
+  input.data += decoded_size;
+  input.size -= decoded_size;
+  output.data += decoded_size / code_points_per_group * bytes_per_group;
+  output.size -= decoded_size / code_points_per_group * bytes_per_group;
+
   char16_t const* const input_end = input.data + input.size;
   std::uint8_t const* const output_end = output.data + output.size;
   std::int64_t output_bit_index = 0;
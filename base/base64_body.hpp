@@ -3,9 +3,11 @@
 
 #include "base/base64.hpp"
 
+#include <cstring>
 #include <string>
 
 #include "absl/strings/escaping.h"
+#include "base/encoding_kernels.hpp"
 
 namespace principia {
 namespace base {
@@ -13,11 +15,21 @@ namespace internal_base64 {
 
 constexpr std::int64_t bits_per_byte = 8;
 constexpr std::int64_t bits_per_char = 6;
+constexpr std::int64_t bytes_per_block = 3;
+constexpr std::int64_t chars_per_block = 4;
 
 template<bool null_terminated>
 void principia::base::internal_base64::Base64Encoder<null_terminated>::Encode(
     Array<std::uint8_t const> input,
     Array<char> output) {
+  // The kernel encodes a prefix made of complete blocks of 3 bytes, Abseil
+  // encodes the rest.
+  std::int64_t const encoded_size =
+      EncodeBase64Prefix(input.data, input.size, output.data);
+  input.data += encoded_size;
+  input.size -= encoded_size;
+  output.data += encoded_size / bytes_per_block * chars_per_block;
+
   std::string_view const input_view(reinterpret_cast<const char*>(input.data),
                                     input.size);
   std::string output_string;
@@ -54,6 +66,14 @@ std::int64_t Base64Encoder<null_terminated>::EncodedLength(
 template<bool null_terminated>
 void Base64Encoder<null_terminated>::Decode(Array<char const> input,
                                             Array<std::uint8_t> output) {
+  // The kernel decodes a prefix made of complete blocks of 4 characters, Abseil
+  // decodes the rest, including any invalid characters.
+  std::int64_t const decoded_size =
+      DecodeBase64Prefix(input.data, input.size, output.data);
+  input.data += decoded_size;
+  input.size -= decoded_size;
+  output.data += decoded_size / chars_per_block * bytes_per_block;
+
   std::string_view const input_view(input.data, input.size);
   std::string output_string;
   absl::WebSafeBase64Unescape(input_view, &output_string);
@@ -0,0 +1,122 @@
+#include "base/cpuid.hpp"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#if PRINCIPIA_COMPILER_MSVC
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace principia {
+namespace base {
+namespace internal_cpuid {
+
+namespace {
+
+struct CPUIDResult {
+  std::uint32_t eax;
+  std::uint32_t ebx;
+  std::uint32_t ecx;
+  std::uint32_t edx;
+};
+
+CPUIDResult CPUID(std::uint32_t const eax, std::uint32_t const ecx) {
+  CPUIDResult result;
+#if PRINCIPIA_COMPILER_MSVC
+  int registers[4];
+  __cpuidex(registers, eax, ecx);
+  result.eax = registers[0];
+  result.ebx = registers[1];
+  result.ecx = registers[2];
+  result.edx = registers[3];
+#else
+  __cpuid_count(eax, ecx, result.eax, result.ebx, result.ecx, result.edx);
+#endif
+  return result;
+}
+
+// Returns the low half of the extended control register XCR0, which tells us
+// which states are saved by the operating system on context switches.
+std::uint32_t XCR0() {
+#if PRINCIPIA_COMPILER_MSVC
+  return static_cast<std::uint32_t>(_xgetbv(0));
+#else
+  std::uint32_t eax;
+  std::uint32_t edx;
+  __asm__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+#endif
+}
+
+bool Bit(std::uint32_t const value, int const bit) {
+  return (value >> bit) & 1;
+}
+
+CPUFeatureFlags DetectCPUFeatures() {
+  std::uint64_t features = 0;
+  auto const set = [&features](CPUFeatureFlags const feature,
+                               bool const supported) {
+    if (supported) {
+      features |= static_cast<std::uint64_t>(feature);
+    }
+  };
+
+  std::uint32_t const max_leaf = CPUID(0, 0).eax;
+  if (max_leaf < 1) {
+    return CPUFeatureFlags::None;
+  }
+  // See Table 3-10 of the Software Developer's Manual for the leaf 1 and
+  // Table 3-8 for the leaf 7.
+  CPUIDResult const leaf_1 = CPUID(1, 0);
+  set(CPUFeatureFlags::SSE3, Bit(leaf_1.ecx, 0));
+  set(CPUFeatureFlags::SSSE3, Bit(leaf_1.ecx, 9));
+  set(CPUFeatureFlags::SSE4_1, Bit(leaf_1.ecx, 19));
+
+  // The AVX instructions may only be used if the operating system saves the
+  // XMM and YMM states, see section 14.3 of the Software Developer's Manual.
+  bool const os_saves_ymm = Bit(leaf_1.ecx, 27) &&  // OSXSAVE.
+                            (XCR0() & 0b110) == 0b110;
+  bool const avx = os_saves_ymm && Bit(leaf_1.ecx, 28);
+  set(CPUFeatureFlags::AVX, avx);
+  set(CPUFeatureFlags::FMA, avx && Bit(leaf_1.ecx, 12));
+  if (max_leaf >= 7) {
+    CPUIDResult const leaf_7 = CPUID(7, 0);
+    set(CPUFeatureFlags::AVX2, avx && Bit(leaf_7.ebx, 5));
+  }
+  return static_cast<CPUFeatureFlags>(features);
+}
+
+}  // namespace
+
+bool HasCPUFeatures(CPUFeatureFlags const features) {
+  static CPUFeatureFlags const detected_features = DetectCPUFeatures();
+  return (static_cast<std::uint64_t>(detected_features) &
+          static_cast<std::uint64_t>(features)) ==
+         static_cast<std::uint64_t>(features);
+}
+
+std::string CPUFeatures() {
+  std::string result;
+  for (auto const& [feature, name] :
+       {std::pair{CPUFeatureFlags::SSE3, "SSE3"},
+        std::pair{CPUFeatureFlags::SSSE3, "SSSE3"},
+        std::pair{CPUFeatureFlags::SSE4_1, "SSE4.1"},
+        std::pair{CPUFeatureFlags::FMA, "FMA"},
+        std::pair{CPUFeatureFlags::AVX, "AVX"},
+        std::pair{CPUFeatureFlags::AVX2, "AVX2"}}) {
+    if (HasCPUFeatures(feature)) {
+      if (!result.empty()) {
+        result += " ";
+      }
+      result += name;
+    }
+  }
+  return result;
+}
+
+}  // namespace internal_cpuid
+}  // namespace base
+}  // namespace principia
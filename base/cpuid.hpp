@@ -0,0 +1,47 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "base/macros.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_cpuid {
+
+// The processor features that may be used by code that dispatches at runtime on
+// the instruction set.  The names follow the Intel® 64 and IA-32 Architectures
+// Software Developer's Manual.
+enum class CPUFeatureFlags : std::uint64_t {
+  None = 0,
+  SSE3 = 1 << 0,
+  SSSE3 = 1 << 1,
+  SSE4_1 = 1 << 2,
+  FMA = 1 << 3,
+  // Only set if the operating system saves the AVX state.
+  AVX = 1 << 4,
+  AVX2 = 1 << 5,
+};
+
+constexpr CPUFeatureFlags operator|(CPUFeatureFlags const left,
+                                    CPUFeatureFlags const right) {
+  return static_cast<CPUFeatureFlags>(static_cast<std::uint64_t>(left) |
+                                      static_cast<std::uint64_t>(right));
+}
+
+// Returns true iff the processor (and the operating system) support all the
+// given |features|.  The detection is only done once.
+bool HasCPUFeatures(CPUFeatureFlags features);
+
+// Returns a human-readable list of the supported features, e.g., for logging.
+std::string CPUFeatures();
+
+}  // namespace internal_cpuid
+
+using internal_cpuid::CPUFeatureFlags;
+using internal_cpuid::CPUFeatures;
+using internal_cpuid::HasCPUFeatures;
+
+}  // namespace base
+}  // namespace principia
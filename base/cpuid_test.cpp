@@ -0,0 +1,36 @@
+#include "base/cpuid.hpp"
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+class CPUIDTest : public ::testing::Test {};
+
+TEST_F(CPUIDTest, Consistency) {
+  EXPECT_TRUE(HasCPUFeatures(CPUFeatureFlags::None));
+  if (HasCPUFeatures(CPUFeatureFlags::AVX2)) {
+    EXPECT_TRUE(HasCPUFeatures(CPUFeatureFlags::AVX));
+  }
+  if (HasCPUFeatures(CPUFeatureFlags::FMA)) {
+    EXPECT_TRUE(HasCPUFeatures(CPUFeatureFlags::AVX));
+  }
+  EXPECT_EQ(HasCPUFeatures(CPUFeatureFlags::AVX) &&
+                HasCPUFeatures(CPUFeatureFlags::AVX2),
+            HasCPUFeatures(CPUFeatureFlags::AVX | CPUFeatureFlags::AVX2));
+}
+
+TEST_F(CPUIDTest, Names) {
+  if (HasCPUFeatures(CPUFeatureFlags::AVX2)) {
+    EXPECT_THAT(CPUFeatures(), HasSubstr("AVX2"));
+  } else {
+    EXPECT_THAT(CPUFeatures(), Not(HasSubstr("AVX2")));
+  }
+}
+
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,626 @@
+﻿
+#include "base/encoding_kernels.hpp"
+
+#include <immintrin.h>
+
+#include <cstring>
+
+#include "base/cpuid.hpp"
+#include "base/macros.hpp"
+
+// On MSVC the intrinsics may be used in any function, but GCC and Clang only
+// accept them in functions compiled for the appropriate target.
+#if PRINCIPIA_COMPILER_MSVC
+#define PRINCIPIA_TARGET_SSSE3
+#define PRINCIPIA_TARGET_AVX2
+#else
+#define PRINCIPIA_TARGET_SSSE3 __attribute__((target("ssse3")))
+#define PRINCIPIA_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+
+namespace principia {
+namespace base {
+namespace internal_encoding_kernels {
+
+using base::CPUFeatureFlags;
+using base::HasCPUFeatures;
+
+namespace {
+
+constexpr std::int64_t base32768_bytes_per_group = 15;
+constexpr std::int64_t base32768_code_points_per_group = 8;
+
+bool HasSSSE3() {
+  static bool const has_ssse3 = HasCPUFeatures(CPUFeatureFlags::SSSE3);
+  return has_ssse3;
+}
+
+bool HasAVX2() {
+  static bool const has_avx2 = HasCPUFeatures(CPUFeatureFlags::AVX2);
+  return has_avx2;
+}
+
+// Returns all ones in the bytes of |characters| that are in [first, last].
+PRINCIPIA_TARGET_SSSE3
+__m128i InRange(__m128i const characters, char const first, char const last) {
+  return _mm_and_si128(_mm_cmpgt_epi8(characters, _mm_set1_epi8(first - 1)),
+                       _mm_cmpgt_epi8(_mm_set1_epi8(last + 1), characters));
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i InRange(__m256i const characters, char const first, char const last) {
+  return _mm256_and_si256(
+      _mm256_cmpgt_epi8(characters, _mm256_set1_epi8(first - 1)),
+      _mm256_cmpgt_epi8(_mm256_set1_epi8(last + 1), characters));
+}
+
+// Hexadecimal.
+
+PRINCIPIA_TARGET_SSSE3
+__m128i HexadecimalDigits(__m128i const nibbles) {
+  __m128i const digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                       '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+  return _mm_shuffle_epi8(digits, nibbles);
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i HexadecimalDigits(__m256i const nibbles) {
+  __m256i const digits = _mm256_setr_epi8(
+      '0', '1', '2', '3', '4', '5', '6', '7',
+      '8', '9', 'A', 'B', 'C', 'D', 'E', 'F',
+      '0', '1', '2', '3', '4', '5', '6', '7',
+      '8', '9', 'A', 'B', 'C', 'D', 'E', 'F');
+  return _mm256_shuffle_epi8(digits, nibbles);
+}
+
+// Returns the values of the hexadecimal digits in |characters|, 0 for invalid
+// digits.  The comparisons are signed, so the characters above 0x7F are
+// invalid.
+PRINCIPIA_TARGET_SSSE3
+__m128i HexadecimalNibbles(__m128i const characters) {
+  // Maps 'A'-'F' to 'a'-'f', and no other character to 'a'-'f'.
+  __m128i const lower = _mm_or_si128(characters, _mm_set1_epi8(0x20));
+  __m128i const is_decimal = InRange(characters, '0', '9');
+  __m128i const is_letter = InRange(lower, 'a', 'f');
+  return _mm_or_si128(
+      _mm_and_si128(is_decimal,
+                    _mm_sub_epi8(characters, _mm_set1_epi8('0'))),
+      _mm_and_si128(is_letter,
+                    _mm_sub_epi8(lower, _mm_set1_epi8('a' - 10))));
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i HexadecimalNibbles(__m256i const characters) {
+  __m256i const lower = _mm256_or_si256(characters, _mm256_set1_epi8(0x20));
+  __m256i const is_decimal = InRange(characters, '0', '9');
+  __m256i const is_letter = InRange(lower, 'a', 'f');
+  return _mm256_or_si256(
+      _mm256_and_si256(is_decimal,
+                       _mm256_sub_epi8(characters, _mm256_set1_epi8('0'))),
+      _mm256_and_si256(is_letter,
+                       _mm256_sub_epi8(lower, _mm256_set1_epi8('a' - 10))));
+}
+
+PRINCIPIA_TARGET_SSSE3
+std::int64_t EncodeHexadecimalSuffixSSSE3(std::uint8_t const* const input,
+                                          std::int64_t const size,
+                                          char* const output) {
+  __m128i const low_nibble = _mm_set1_epi8(0x0F);
+  std::int64_t begin = size;
+  for (; begin >= 16; begin -= 16) {
+    __m128i const bytes = _mm_loadu_si128(
+        reinterpret_cast<__m128i const*>(&input[begin - 16]));
+    __m128i const high = HexadecimalDigits(
+        _mm_and_si128(_mm_srli_epi16(bytes, 4), low_nibble));
+    __m128i const low = HexadecimalDigits(_mm_and_si128(bytes, low_nibble));
+    auto* const block = reinterpret_cast<__m128i*>(&output[2 * (begin - 16)]);
+    _mm_storeu_si128(&block[0], _mm_unpacklo_epi8(high, low));
+    _mm_storeu_si128(&block[1], _mm_unpackhi_epi8(high, low));
+  }
+  return size - begin;
+}
+
+PRINCIPIA_TARGET_AVX2
+std::int64_t EncodeHexadecimalSuffixAVX2(std::uint8_t const* const input,
+                                         std::int64_t const size,
+                                         char* const output) {
+  __m256i const low_nibble = _mm256_set1_epi8(0x0F);
+  std::int64_t begin = size;
+  for (; begin >= 32; begin -= 32) {
+    __m256i const bytes = _mm256_loadu_si256(
+        reinterpret_cast<__m256i const*>(&input[begin - 32]));
+    __m256i const high = HexadecimalDigits(
+        _mm256_and_si256(_mm256_srli_epi16(bytes, 4), low_nibble));
+    __m256i const low =
+        HexadecimalDigits(_mm256_and_si256(bytes, low_nibble));
+    // The unpacking operates within 128-bit lanes: |first| has the digits of
+    // bytes 0-7 and 16-23, |second| those of bytes 8-15 and 24-31.
+    __m256i const first = _mm256_unpacklo_epi8(high, low);
+    __m256i const second = _mm256_unpackhi_epi8(high, low);
+    auto* const block = reinterpret_cast<__m256i*>(&output[2 * (begin - 32)]);
+    _mm256_storeu_si256(&block[0],
+                        _mm256_permute2x128_si256(first, second, 0x20));
+    _mm256_storeu_si256(&block[1],
+                        _mm256_permute2x128_si256(first, second, 0x31));
+  }
+  return size - begin;
+}
+
+PRINCIPIA_TARGET_SSSE3
+std::int64_t DecodeHexadecimalPrefixSSSE3(char const* const input,
+                                          std::int64_t const size,
+                                          std::uint8_t* const output) {
+  // Multiplies the high nibble by 16 and adds the low nibble.
+  __m128i const weights = _mm_set1_epi16(0x0110);
+  std::int64_t end = 0;
+  for (; end + 32 <= size; end += 32) {
+    auto const* const block = reinterpret_cast<__m128i const*>(&input[end]);
+    __m128i const first =
+        _mm_maddubs_epi16(HexadecimalNibbles(_mm_loadu_si128(&block[0])),
+                          weights);
+    __m128i const second =
+        _mm_maddubs_epi16(HexadecimalNibbles(_mm_loadu_si128(&block[1])),
+                          weights);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&output[end / 2]),
+                     _mm_packus_epi16(first, second));
+  }
+  return end;
+}
+
+PRINCIPIA_TARGET_AVX2
+std::int64_t DecodeHexadecimalPrefixAVX2(char const* const input,
+                                         std::int64_t const size,
+                                         std::uint8_t* const output) {
+  __m256i const weights = _mm256_set1_epi16(0x0110);
+  std::int64_t end = 0;
+  for (; end + 64 <= size; end += 64) {
+    auto const* const block = reinterpret_cast<__m256i const*>(&input[end]);
+    __m256i const first = _mm256_maddubs_epi16(
+        HexadecimalNibbles(_mm256_loadu_si256(&block[0])), weights);
+    __m256i const second = _mm256_maddubs_epi16(
+        HexadecimalNibbles(_mm256_loadu_si256(&block[1])), weights);
+    // The packing operates within 128-bit lanes, put the quadwords back in
+    // order.
+    _mm256_storeu_si256(
+        reinterpret_cast<__m256i*>(&output[end / 2]),
+        _mm256_permute4x64_epi64(_mm256_packus_epi16(first, second), 0xD8));
+  }
+  return end;
+}
+
+// Base64.  The algorithms are those of Muła, Kurz and Lemire, Faster Base64
+// Encoding and Decoding Using AVX2 Instructions [MKL18], adapted to the
+// base64url alphabet.
+
+// Returns the base64url characters for the 6-bit values in |indices|.
+PRINCIPIA_TARGET_SSSE3
+__m128i Base64Characters(__m128i const indices) {
+  // Reduces 0-51 to 0, 52-61 to 1-10, 62 to 11 and 63 to 12, then
+  // distinguishes 0-25, which becomes 13, from 26-51, which remains 0.
+  __m128i offset_index = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+  __m128i const is_upper = _mm_cmpgt_epi8(_mm_set1_epi8(26), indices);
+  offset_index =
+      _mm_or_si128(offset_index, _mm_and_si128(is_upper, _mm_set1_epi8(13)));
+  __m128i const offsets = _mm_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0);
+  return _mm_add_epi8(_mm_shuffle_epi8(offsets, offset_index), indices);
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i Base64Characters(__m256i const indices) {
+  __m256i offset_index = _mm256_subs_epu8(indices, _mm256_set1_epi8(51));
+  __m256i const is_upper = _mm256_cmpgt_epi8(_mm256_set1_epi8(26), indices);
+  offset_index = _mm256_or_si256(
+      offset_index, _mm256_and_si256(is_upper, _mm256_set1_epi8(13)));
+  __m256i const offsets = _mm256_setr_epi8(
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0,
+      'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '-' - 62, '_' - 63, 'A', 0, 0);
+  return _mm256_add_epi8(_mm256_shuffle_epi8(offsets, offset_index), indices);
+}
+
+// Splits the first 12 bytes of each 128-bit lane of |bytes| into 16 6-bit
+// values.
+PRINCIPIA_TARGET_SSSE3
+__m128i Base64Indices(__m128i const bytes) {
+  // Each doubleword receives the bytes [b1, b0, b2, b1] of a block.
+  __m128i const blocks = _mm_shuffle_epi8(
+      bytes, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  __m128i const first_and_third = _mm_mulhi_epu16(
+      _mm_and_si128(blocks, _mm_set1_epi32(0x0FC0FC00)),
+      _mm_set1_epi32(0x04000040));
+  __m128i const second_and_fourth = _mm_mullo_epi16(
+      _mm_and_si128(blocks, _mm_set1_epi32(0x003F03F0)),
+      _mm_set1_epi32(0x01000010));
+  return _mm_or_si128(first_and_third, second_and_fourth);
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i Base64Indices(__m256i const bytes) {
+  __m256i const blocks = _mm256_shuffle_epi8(
+      bytes,
+      _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10,
+                       1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  __m256i const first_and_third = _mm256_mulhi_epu16(
+      _mm256_and_si256(blocks, _mm256_set1_epi32(0x0FC0FC00)),
+      _mm256_set1_epi32(0x04000040));
+  __m256i const second_and_fourth = _mm256_mullo_epi16(
+      _mm256_and_si256(blocks, _mm256_set1_epi32(0x003F03F0)),
+      _mm256_set1_epi32(0x01000010));
+  return _mm256_or_si256(first_and_third, second_and_fourth);
+}
+
+// Returns the 6-bit values of the base64url |characters|, and sets |valid| to
+// all ones in the bytes where the character is in the alphabet.
+PRINCIPIA_TARGET_SSSE3
+__m128i Base64Values(__m128i const characters, __m128i& valid) {
+  __m128i const is_upper = InRange(characters, 'A', 'Z');
+  __m128i const is_lower = InRange(characters, 'a', 'z');
+  __m128i const is_digit = InRange(characters, '0', '9');
+  __m128i const is_minus = _mm_cmpeq_epi8(characters, _mm_set1_epi8('-'));
+  __m128i const is_underscore = _mm_cmpeq_epi8(characters, _mm_set1_epi8('_'));
+  valid = _mm_or_si128(_mm_or_si128(_mm_or_si128(is_upper, is_lower),
+                                    _mm_or_si128(is_digit, is_minus)),
+                       is_underscore);
+  __m128i const offsets = _mm_or_si128(
+      _mm_or_si128(
+          _mm_and_si128(is_upper, _mm_set1_epi8(-'A')),
+          _mm_and_si128(is_lower, _mm_set1_epi8(26 - 'a'))),
+      _mm_or_si128(
+          _mm_and_si128(is_digit, _mm_set1_epi8(52 - '0')),
+          _mm_or_si128(_mm_and_si128(is_minus, _mm_set1_epi8(62 - '-')),
+                       _mm_and_si128(is_underscore, _mm_set1_epi8(63 - '_')))));
+  return _mm_add_epi8(characters, offsets);
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i Base64Values(__m256i const characters, __m256i& valid) {
+  __m256i const is_upper = InRange(characters, 'A', 'Z');
+  __m256i const is_lower = InRange(characters, 'a', 'z');
+  __m256i const is_digit = InRange(characters, '0', '9');
+  __m256i const is_minus =
+      _mm256_cmpeq_epi8(characters, _mm256_set1_epi8('-'));
+  __m256i const is_underscore =
+      _mm256_cmpeq_epi8(characters, _mm256_set1_epi8('_'));
+  valid = _mm256_or_si256(_mm256_or_si256(_mm256_or_si256(is_upper, is_lower),
+                                          _mm256_or_si256(is_digit, is_minus)),
+                          is_underscore);
+  __m256i const offsets = _mm256_or_si256(
+      _mm256_or_si256(
+          _mm256_and_si256(is_upper, _mm256_set1_epi8(-'A')),
+          _mm256_and_si256(is_lower, _mm256_set1_epi8(26 - 'a'))),
+      _mm256_or_si256(
+          _mm256_and_si256(is_digit, _mm256_set1_epi8(52 - '0')),
+          _mm256_or_si256(
+              _mm256_and_si256(is_minus, _mm256_set1_epi8(62 - '-')),
+              _mm256_and_si256(is_underscore, _mm256_set1_epi8(63 - '_')))));
+  return _mm256_add_epi8(characters, offsets);
+}
+
+// Packs the 16 6-bit |values| of each 128-bit lane into the first 12 bytes of
+// that lane.
+PRINCIPIA_TARGET_SSSE3
+__m128i Base64Bytes(__m128i const values) {
+  __m128i const pairs =
+      _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+  __m128i const quadruples = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(
+      quadruples,
+      _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+PRINCIPIA_TARGET_AVX2
+__m256i Base64Bytes(__m256i const values) {
+  __m256i const pairs =
+      _mm256_maddubs_epi16(values, _mm256_set1_epi32(0x01400140));
+  __m256i const quadruples =
+      _mm256_madd_epi16(pairs, _mm256_set1_epi32(0x00011000));
+  return _mm256_shuffle_epi8(
+      quadruples,
+      _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                       2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+// Stores the first 12 bytes of |bytes| at |output|.
+PRINCIPIA_TARGET_SSSE3
+void Store12(__m128i const bytes, std::uint8_t* const output) {
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(output), bytes);
+  std::int32_t const last = _mm_cvtsi128_si32(_mm_srli_si128(bytes, 8));
+  std::memcpy(&output[8], &last, sizeof(last));
+}
+
+PRINCIPIA_TARGET_SSSE3
+std::int64_t EncodeBase64PrefixSSSE3(std::uint8_t const* const input,
+                                     std::int64_t const size,
+                                     char* const output) {
+  std::int64_t end = 0;
+  char* block_output = output;
+  // Each iteration reads 16 bytes and encodes the first 12.
+  for (; end + 16 <= size; end += 12, block_output += 16) {
+    __m128i const bytes =
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(&input[end]));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(block_output),
+                     Base64Characters(Base64Indices(bytes)));
+  }
+  return end;
+}
+
+PRINCIPIA_TARGET_AVX2
+std::int64_t EncodeBase64PrefixAVX2(std::uint8_t const* const input,
+                                    std::int64_t const size,
+                                    char* const output) {
+  std::int64_t end = 0;
+  char* block_output = output;
+  // Each iteration reads 28 bytes and encodes the first 24, 12 in each lane.
+  for (; end + 28 <= size; end += 24, block_output += 32) {
+    __m256i const bytes = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<__m128i const*>(&input[end]))),
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(&input[end + 12])),
+        1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(block_output),
+                        Base64Characters(Base64Indices(bytes)));
+  }
+  return end;
+}
+
+PRINCIPIA_TARGET_SSSE3
+std::int64_t DecodeBase64PrefixSSSE3(char const* const input,
+                                     std::int64_t const size,
+                                     std::uint8_t* const output) {
+  std::int64_t end = 0;
+  std::uint8_t* block_output = output;
+  for (; end + 16 <= size; end += 16, block_output += 12) {
+    __m128i valid;
+    __m128i const values = Base64Values(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(&input[end])), valid);
+    if (_mm_movemask_epi8(valid) != 0xFFFF) {
+      break;
+    }
+    Store12(Base64Bytes(values), block_output);
+  }
+  return end;
+}
+
+PRINCIPIA_TARGET_AVX2
+std::int64_t DecodeBase64PrefixAVX2(char const* const input,
+                                    std::int64_t const size,
+                                    std::uint8_t* const output) {
+  std::int64_t end = 0;
+  std::uint8_t* block_output = output;
+  for (; end + 32 <= size; end += 32, block_output += 24) {
+    __m256i valid;
+    __m256i const values = Base64Values(
+        _mm256_loadu_si256(reinterpret_cast<__m256i const*>(&input[end])),
+        valid);
+    if (_mm256_movemask_epi8(valid) != -1) {
+      break;
+    }
+    __m256i const bytes = Base64Bytes(values);
+    Store12(_mm256_castsi256_si128(bytes), block_output);
+    Store12(_mm256_extracti128_si256(bytes, 1), block_output + 12);
+  }
+  return end;
+}
+
+// Base32768.  The 120 bits of a group are handled as a big-endian word |high|
+// of 64 bits followed by a big-endian word |low| of 56 bits stored in the most
+// significant bits.
+
+std::uint64_t LoadBigEndian(std::uint8_t const* const bytes,
+                            int const size) {
+  std::uint64_t word = 0;
+  for (int i = 0; i < size; ++i) {
+    word = word << 8 | bytes[i];
+  }
+  return word << (8 * (8 - size));
+}
+
+void StoreBigEndian(std::uint64_t word,
+                    int const size,
+                    std::uint8_t* const bytes) {
+  for (int i = 0; i < size; ++i) {
+    bytes[i] = word >> 56;
+    word <<= 8;
+  }
+}
+
+void StoreGroup(std::uint64_t const high,
+                std::uint64_t const low,
+                std::uint8_t* const output) {
+  StoreBigEndian(high, 8, output);
+  StoreBigEndian(low, 7, output + 8);
+}
+
+PRINCIPIA_TARGET_AVX2
+std::int64_t EncodeBase32768PrefixAVX2(std::uint8_t const* const input,
+                                       std::int64_t const size,
+                                       char16_t const* const encoding_table,
+                                       char16_t* const output) {
+  // The doubleword k receives, in big-endian order, the 3 bytes that contain
+  // the 15 bits of the value k.  The value k starts at bit 15 k, i.e., at bit
+  // 15 k mod 8 of byte ⌊15 k / 8⌋, hence the shifts.
+  __m256i const shuffle = _mm256_setr_epi8(
+      2, 1, 0, -1, 3, 2, 1, -1, 5, 4, 3, -1, 7, 6, 5, -1,
+      9, 8, 7, -1, 11, 10, 9, -1, 13, 12, 11, -1, 15, 14, 13, -1);
+  __m256i const shifts = _mm256_setr_epi32(9, 2, 3, 4, 5, 6, 7, 8);
+  std::int64_t end = 0;
+  char16_t* group_output = output;
+  // Each iteration reads 16 bytes and encodes the first 15.
+  for (; end + 16 <= size;
+       end += base32768_bytes_per_group,
+       group_output += base32768_code_points_per_group) {
+    __m256i const bytes = _mm256_broadcastsi128_si256(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(&input[end])));
+    __m256i const values = _mm256_and_si256(
+        _mm256_srlv_epi32(_mm256_shuffle_epi8(bytes, shuffle), shifts),
+        _mm256_set1_epi32(0x7FFF));
+    // The gather reads 32 bits, the low 16 bits are the code point.
+    __m256i const code_points = _mm256_and_si256(
+        _mm256_i32gather_epi32(
+            reinterpret_cast<int const*>(encoding_table), values, 2),
+        _mm256_set1_epi32(0xFFFF));
+    __m256i const packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(code_points, code_points), 0x08);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(group_output),
+                     _mm256_castsi256_si128(packed));
+  }
+  return end;
+}
+
+PRINCIPIA_TARGET_AVX2
+std::int64_t DecodeBase32768PrefixAVX2(
+    char16_t const* const input,
+    std::int64_t const size,
+    std::uint16_t const* const decoding_table,
+    std::uint8_t* const output) {
+  std::int64_t end = 0;
+  std::uint8_t* group_output = output;
+  for (; end + base32768_code_points_per_group <= size;
+       end += base32768_code_points_per_group,
+       group_output += base32768_bytes_per_group) {
+    __m256i const code_points = _mm256_cvtepu16_epi32(
+        _mm_loadu_si128(reinterpret_cast<__m128i const*>(&input[end])));
+    __m256i const values = _mm256_and_si256(
+        _mm256_i32gather_epi32(
+            reinterpret_cast<int const*>(decoding_table), code_points, 2),
+        _mm256_set1_epi32(0xFFFF));
+    // Concatenate the values by pairs in each quadword, and then the pairs in
+    // the first quadword of each 128-bit lane, which thus contains 60 bits.
+    __m256i const pairs = _mm256_or_si256(
+        _mm256_slli_epi64(
+            _mm256_and_si256(values, _mm256_set1_epi64x(0xFFFF'FFFF)), 15),
+        _mm256_srli_epi64(values, 32));
+    __m256i const quadruples = _mm256_or_si256(
+        _mm256_slli_epi64(pairs, 30), _mm256_unpackhi_epi64(pairs, pairs));
+    std::uint64_t const first = _mm256_extract_epi64(quadruples, 0);
+    std::uint64_t const second = _mm256_extract_epi64(quadruples, 2);
+    StoreGroup(first << 4 | second >> 56, second << 8, group_output);
+  }
+  return end;
+}
+
+}  // namespace
+
+std::int64_t EncodeHexadecimalSuffix(std::uint8_t const* const input,
+                                     std::int64_t const size,
+                                     char* const output) {
+  if (HasAVX2()) {
+    return EncodeHexadecimalSuffixAVX2(input, size, output);
+  } else if (HasSSSE3()) {
+    return EncodeHexadecimalSuffixSSSE3(input, size, output);
+  } else {
+    return 0;
+  }
+}
+
+std::int64_t DecodeHexadecimalPrefix(char const* const input,
+                                     std::int64_t const size,
+                                     std::uint8_t* const output) {
+  if (HasAVX2()) {
+    return DecodeHexadecimalPrefixAVX2(input, size, output);
+  } else if (HasSSSE3()) {
+    return DecodeHexadecimalPrefixSSSE3(input, size, output);
+  } else {
+    return 0;
+  }
+}
+
+std::int64_t EncodeBase64Prefix(std::uint8_t const* const input,
+                                std::int64_t const size,
+                                char* const output) {
+  if (HasAVX2()) {
+    return EncodeBase64PrefixAVX2(input, size, output);
+  } else if (HasSSSE3()) {
+    return EncodeBase64PrefixSSSE3(input, size, output);
+  } else {
+    return 0;
+  }
+}
+
+std::int64_t DecodeBase64Prefix(char const* const input,
+                                std::int64_t const size,
+                                std::uint8_t* const output) {
+  if (HasAVX2()) {
+    return DecodeBase64PrefixAVX2(input, size, output);
+  } else if (HasSSSE3()) {
+    return DecodeBase64PrefixSSSE3(input, size, output);
+  } else {
+    return 0;
+  }
+}
+
+std::int64_t EncodeBase32768Prefix(std::uint8_t const* const input,
+                                   std::int64_t const size,
+                                   char16_t const* const encoding_table,
+                                   char16_t* const output) {
+  if (HasAVX2()) {
+    return EncodeBase32768PrefixAVX2(input, size, encoding_table, output);
+  } else {
+    return EncodeBase32768PrefixScalar(input, size, encoding_table, output);
+  }
+}
+
+std::int64_t DecodeBase32768Prefix(char16_t const* const input,
+                                   std::int64_t const size,
+                                   std::uint16_t const* const decoding_table,
+                                   std::uint8_t* const output) {
+  if (HasAVX2()) {
+    return DecodeBase32768PrefixAVX2(input, size, decoding_table, output);
+  } else {
+    return DecodeBase32768PrefixScalar(input, size, decoding_table, output);
+  }
+}
+
+std::int64_t EncodeBase32768PrefixScalar(std::uint8_t const* const input,
+                                         std::int64_t const size,
+                                         char16_t const* const encoding_table,
+                                         char16_t* const output) {
+  std::int64_t end = 0;
+  char16_t* group_output = output;
+  for (; end + base32768_bytes_per_group <= size;
+       end += base32768_bytes_per_group,
+       group_output += base32768_code_points_per_group) {
+    std::uint64_t const high = LoadBigEndian(&input[end], 8);
+    std::uint64_t const low = LoadBigEndian(&input[end + 8], 7);
+    group_output[0] = encoding_table[high >> 49];
+    group_output[1] = encoding_table[(high >> 34) & 0x7FFF];
+    group_output[2] = encoding_table[(high >> 19) & 0x7FFF];
+    group_output[3] = encoding_table[(high >> 4) & 0x7FFF];
+    group_output[4] = encoding_table[(high << 11 | low >> 53) & 0x7FFF];
+    group_output[5] = encoding_table[(low >> 38) & 0x7FFF];
+    group_output[6] = encoding_table[(low >> 23) & 0x7FFF];
+    group_output[7] = encoding_table[(low >> 8) & 0x7FFF];
+  }
+  return end;
+}
+
+std::int64_t DecodeBase32768PrefixScalar(
+    char16_t const* const input,
+    std::int64_t const size,
+    std::uint16_t const* const decoding_table,
+    std::uint8_t* const output) {
+  std::int64_t end = 0;
+  std::uint8_t* group_output = output;
+  for (; end + base32768_code_points_per_group <= size;
+       end += base32768_code_points_per_group,
+       group_output += base32768_bytes_per_group) {
+    std::uint64_t values[base32768_code_points_per_group];
+    for (int i = 0; i < base32768_code_points_per_group; ++i) {
+      values[i] = decoding_table[input[end + i]];
+    }
+    std::uint64_t const high = values[0] << 49 | values[1] << 34 |
+                               values[2] << 19 | values[3] << 4 |
+                               values[4] >> 11;
+    std::uint64_t const low = values[4] << 53 | values[5] << 38 |
+                              values[6] << 23 | values[7] << 8;
+    StoreGroup(high, low, group_output);
+  }
+  return end;
+}
+
+}  // namespace internal_encoding_kernels
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,86 @@
+﻿
+#pragma once
+
+#include <cstdint>
+
+namespace principia {
+namespace base {
+namespace internal_encoding_kernels {
+
+// The kernels below process the bulk of the data for |HexadecimalEncoder|,
+// |Base64Encoder| and |Base32768Encoder|.  They use AVX2 or SSSE3 if the
+// processor supports them, and return the number of input elements that they
+// processed, which may be 0; the caller processes the rest with its scalar
+// code.  The results are bitwise identical to those of the scalar code.
+
+// Encodes in upper-case hexadecimal a suffix of [input, input + size[, of
+// length n, to [output + 2 * (size - n), output + 2 * size[.  The suffix is
+// processed backward, and each block is read before being written, so the
+// overlaps allowed by |HexadecimalEncoder::Encode| are supported.  Returns n.
+std::int64_t EncodeHexadecimalSuffix(std::uint8_t const* input,
+                                     std::int64_t size,
+                                     char* output);
+
+// Decodes the hexadecimal digits of a prefix of [input, input + size[, of even
+// length n, to [output, output + n / 2[.  Invalid digits are read as 0.  The
+// overlaps allowed by |HexadecimalEncoder::Decode| are supported.  Returns n.
+std::int64_t DecodeHexadecimalPrefix(char const* input,
+                                     std::int64_t size,
+                                     std::uint8_t* output);
+
+// Encodes in base64url a prefix of [input, input + size[, of length n, a
+// multiple of 3, to [output, output + 4 * n / 3[.  Returns n.
+std::int64_t EncodeBase64Prefix(std::uint8_t const* input,
+                                std::int64_t size,
+                                char* output);
+
+// Decodes the base64url characters of a prefix of [input, input + size[, of
+// length n, a multiple of 4, to [output, output + 3 * n / 4[.  Stops before the
+// first block that contains a character outside of the base64url alphabet.
+// Returns n.
+std::int64_t DecodeBase64Prefix(char const* input,
+                                std::int64_t size,
+                                std::uint8_t* output);
+
+// Encodes in base32768 a prefix of [input, input + size[ made of groups of 15
+// bytes, of length n, to [output, output + 8 * n / 15[.  |encoding_table| maps
+// a 15-bit value to its code point and must have at least 2¹⁵ + 1 entries.
+// Returns n.
+std::int64_t EncodeBase32768Prefix(std::uint8_t const* input,
+                                   std::int64_t size,
+                                   char16_t const* encoding_table,
+                                   char16_t* output);
+
+// Decodes a prefix of [input, input + size[ made of groups of 8 code points,
+// each of which encodes 15 bits, of length n, to [output, output + 15 * n / 8[.
+// |decoding_table| maps a code point to its 15-bit value and must have at least
+// 2¹⁶ + 1 entries.  Returns n.
+std::int64_t DecodeBase32768Prefix(char16_t const* input,
+                                   std::int64_t size,
+                                   std::uint16_t const* decoding_table,
+                                   std::uint8_t* output);
+
+// Same as the above two functions, but always use the scalar code.  Exposed for
+// testing.
+std::int64_t EncodeBase32768PrefixScalar(std::uint8_t const* input,
+                                         std::int64_t size,
+                                         char16_t const* encoding_table,
+                                         char16_t* output);
+std::int64_t DecodeBase32768PrefixScalar(char16_t const* input,
+                                         std::int64_t size,
+                                         std::uint16_t const* decoding_table,
+                                         std::uint8_t* output);
+
+}  // namespace internal_encoding_kernels
+
+using internal_encoding_kernels::DecodeBase32768Prefix;
+using internal_encoding_kernels::DecodeBase32768PrefixScalar;
+using internal_encoding_kernels::DecodeBase64Prefix;
+using internal_encoding_kernels::DecodeHexadecimalPrefix;
+using internal_encoding_kernels::EncodeBase32768Prefix;
+using internal_encoding_kernels::EncodeBase32768PrefixScalar;
+using internal_encoding_kernels::EncodeBase64Prefix;
+using internal_encoding_kernels::EncodeHexadecimalSuffix;
+
+}  // namespace base
+}  // namespace principia
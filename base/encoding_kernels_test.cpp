@@ -0,0 +1,224 @@
+#include "base/encoding_kernels.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "absl/strings/escaping.h"
+#include "base/base64.hpp"
+#include "base/hexadecimal.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::Le;
+
+// The sizes are chosen to exercise the vectorized loops, the scalar tails, and
+// the transition between them.
+class EncodingKernelsTest : public ::testing::Test {
+ protected:
+  static constexpr int max_size = 300;
+
+  EncodingKernelsTest() : random_(42) {}
+
+  std::vector<std::uint8_t> RandomBytes(std::int64_t const size) {
+    std::uniform_int_distribution<int> bytes_distribution(0, 255);
+    std::vector<std::uint8_t> bytes(size);
+    for (auto& byte : bytes) {
+      byte = bytes_distribution(random_);
+    }
+    return bytes;
+  }
+
+  std::mt19937_64 random_;
+};
+
+TEST_F(EncodingKernelsTest, Hexadecimal) {
+  HexadecimalEncoder</*null_terminated=*/false> encoder;
+  for (int size = 0; size <= max_size; ++size) {
+    auto const bytes = RandomBytes(size);
+    std::string expected_digits;
+    for (std::uint8_t const byte : bytes) {
+      char digits[3];
+      std::snprintf(digits, sizeof(digits), "%02X", byte);
+      expected_digits += digits;
+    }
+
+    auto const digits = encoder.Encode({bytes.data(), size});
+    EXPECT_EQ(expected_digits, std::string(digits.data.get(), digits.size))
+        << size;
+    auto const decoded_bytes = encoder.Decode(digits.get());
+    EXPECT_EQ(bytes,
+              std::vector<std::uint8_t>(
+                  decoded_bytes.data.get(),
+                  decoded_bytes.data.get() + decoded_bytes.size))
+        << size;
+
+    // In place, the kernel must not overwrite bytes before reading them.
+    std::vector<std::uint8_t> buffer(2 * size);
+    std::copy(bytes.begin(), bytes.end(), buffer.begin());
+    encoder.Encode({buffer.data(), size},
+                   {reinterpret_cast<char*>(buffer.data()), 2 * size});
+    EXPECT_EQ(expected_digits, std::string(buffer.begin(), buffer.end()))
+        << size;
+    encoder.Decode({reinterpret_cast<char const*>(buffer.data()), 2 * size},
+                   {buffer.data(), size});
+    EXPECT_EQ(bytes,
+              std::vector<std::uint8_t>(buffer.begin(), buffer.begin() + size))
+        << size;
+  }
+}
+
+TEST_F(EncodingKernelsTest, HexadecimalInvalidDigits) {
+  HexadecimalEncoder</*null_terminated=*/false> encoder;
+  // Lower-case digits, and characters that are invalid, including some above
+  // 0x7F, which are read as 0.
+  std::string const valid = "0123456789abcdefABCDEF";
+  std::string const invalid = "/:@G`g \x80\xC0\xFF";
+  std::uniform_int_distribution<int> index_distribution(
+      0, valid.size() + invalid.size() - 1);
+  for (int size = 0; size <= max_size; size += 2) {
+    std::string digits;
+    std::vector<std::uint8_t> expected_nibbles;
+    for (int i = 0; i < size; ++i) {
+      int const index = index_distribution(random_);
+      if (index < valid.size()) {
+        digits += valid[index];
+        expected_nibbles.push_back(
+            std::stoi(std::string(1, valid[index]), nullptr, 16));
+      } else {
+        digits += invalid[index - valid.size()];
+        expected_nibbles.push_back(0);
+      }
+    }
+    std::vector<std::uint8_t> expected_bytes;
+    for (int i = 0; i < size; i += 2) {
+      expected_bytes.push_back(expected_nibbles[i] << 4 |
+                               expected_nibbles[i + 1]);
+    }
+    auto const bytes = encoder.Decode({digits.data(), size});
+    EXPECT_EQ(expected_bytes,
+              std::vector<std::uint8_t>(bytes.data.get(),
+                                        bytes.data.get() + bytes.size))
+        << size;
+  }
+}
+
+TEST_F(EncodingKernelsTest, Base64) {
+  Base64Encoder</*null_terminated=*/true> encoder;
+  for (int size = 0; size <= max_size; ++size) {
+    auto const bytes = RandomBytes(size);
+    std::string expected_characters;
+    absl::WebSafeBase64Escape(
+        std::string_view(reinterpret_cast<char const*>(bytes.data()), size),
+        &expected_characters);
+
+    auto const characters = encoder.Encode({bytes.data(), size});
+    EXPECT_EQ(expected_characters, characters.data.get()) << size;
+    auto const decoded_bytes =
+        encoder.Decode({characters.data.get(), characters.size - 1});
+    EXPECT_EQ(bytes,
+              std::vector<std::uint8_t>(
+                  decoded_bytes.data.get(),
+                  decoded_bytes.data.get() + decoded_bytes.size))
+        << size;
+  }
+}
+
+TEST_F(EncodingKernelsTest, Base64InvalidCharacters) {
+  for (int size = 0; size <= max_size; size += 3) {
+    auto const bytes = RandomBytes(size);
+    std::string characters;
+    absl::WebSafeBase64Escape(
+        std::string_view(reinterpret_cast<char const*>(bytes.data()), size),
+        &characters);
+    std::vector<std::uint8_t> decoded_bytes(size);
+    std::int64_t decoded_size = DecodeBase64Prefix(
+        characters.data(), characters.size(), decoded_bytes.data());
+    EXPECT_THAT(decoded_size, Le(static_cast<std::int64_t>(characters.size())))
+        << size;
+    EXPECT_EQ(0, decoded_size % 4);
+    for (std::int64_t i = 0; i < decoded_size / 4 * 3; ++i) {
+      EXPECT_EQ(bytes[i], decoded_bytes[i]) << size << " " << i;
+    }
+    if (characters.empty()) {
+      continue;
+    }
+
+    // The kernel stops before the block that contains the invalid character,
+    // and the bytes that it decoded are correct.
+    std::uniform_int_distribution<std::int64_t> position_distribution(
+        0, characters.size() - 1);
+    std::int64_t const position = position_distribution(random_);
+    characters[position] = '+';
+    decoded_size = DecodeBase64Prefix(
+        characters.data(), characters.size(), decoded_bytes.data());
+    EXPECT_THAT(decoded_size, Le(position)) << size;
+    EXPECT_EQ(0, decoded_size % 4);
+    for (std::int64_t i = 0; i < decoded_size / 4 * 3; ++i) {
+      EXPECT_EQ(bytes[i], decoded_bytes[i]) << size << " " << i;
+    }
+  }
+}
+
+TEST_F(EncodingKernelsTest, Base32768) {
+  // A table that maps the 15-bit values to a few blocks of code points, like
+  // |fifteen_bits| but simpler, with the extra entries required by the gathers.
+  std::vector<char16_t> encoding_table((1 << 15) + 1);
+  std::vector<std::uint16_t> decoding_table((1 << 16) + 1);
+  for (int k = 0; k < 1 << 15; ++k) {
+    char16_t const code_point = 0x4000 + (k & 0x3FFF) + ((k >> 14) << 15);
+    encoding_table[k] = code_point;
+    decoding_table[code_point] = k;
+  }
+
+  for (int size = 0; size <= max_size; ++size) {
+    auto const bytes = RandomBytes(size);
+    std::int64_t const code_points_size = size / 15 * 8;
+    std::vector<char16_t> expected_code_points(code_points_size);
+    std::vector<char16_t> code_points(code_points_size);
+    EXPECT_EQ(size / 15 * 15,
+              EncodeBase32768PrefixScalar(bytes.data(),
+                                          size,
+                                          encoding_table.data(),
+                                          expected_code_points.data()));
+    std::int64_t const encoded_size = EncodeBase32768Prefix(
+        bytes.data(), size, encoding_table.data(), code_points.data());
+    EXPECT_EQ(0, encoded_size % 15);
+    EXPECT_THAT(size - encoded_size, Le(15));
+    code_points.resize(encoded_size / 15 * 8);
+    expected_code_points.resize(encoded_size / 15 * 8);
+    EXPECT_EQ(expected_code_points, code_points) << size;
+
+    // The first code point encodes the 15 most significant bits of the input.
+    if (size >= 15) {
+      EXPECT_EQ(encoding_table[(bytes[0] << 7) | (bytes[1] >> 1)],
+                expected_code_points[0]);
+    }
+
+    std::vector<std::uint8_t> expected_bytes(encoded_size);
+    std::vector<std::uint8_t> decoded_bytes(encoded_size);
+    EXPECT_EQ(code_points.size(),
+              DecodeBase32768PrefixScalar(code_points.data(),
+                                          code_points.size(),
+                                          decoding_table.data(),
+                                          expected_bytes.data()));
+    EXPECT_EQ(code_points.size(),
+              DecodeBase32768Prefix(code_points.data(),
+                                    code_points.size(),
+                                    decoding_table.data(),
+                                    decoded_bytes.data()));
+    EXPECT_EQ(std::vector<std::uint8_t>(bytes.begin(),
+                                        bytes.begin() + encoded_size),
+              expected_bytes)
+        << size;
+    EXPECT_EQ(expected_bytes, decoded_bytes) << size;
+  }
+}
+
+}  // namespace base
+}  // namespace principia
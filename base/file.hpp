@@ -18,6 +18,9 @@ class OFStream {
   OFStream& operator=(OFStream&& other);
   OFStream& operator<<(std::string const& s);
 
+  // Writes the buffered data to the file.
+  void Flush();
+
  private:
   std::ofstream stream_;
 };
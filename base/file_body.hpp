@@ -46,6 +46,11 @@ inline OFStream&  OFStream::operator<<(std::string const& s) {
   return *this;
 }
 
+inline void OFStream::Flush() {
+  CHECK(stream_.good());
+  stream_.flush();
+}
+
 }  // namespace internal_file
 }  // namespace base
 }  // namespace principia
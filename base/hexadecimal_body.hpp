@@ -6,6 +6,7 @@
 #include <cstdint>
 #include <cstring>
 
+#include "base/encoding_kernels.hpp"
 #include "glog/logging.h"
 
 namespace principia {
@@ -54,11 +55,14 @@ void HexadecimalEncoder<null_terminated>::Encode(
         static_cast<void*>(&output.data[input.size << 1]) <= input.data)
       << "bad overlap";
   CHECK_GE(output.size, EncodedLength(input)) << "output too small";
-  // We want the result to start at |output.data[0]|.
-  output.data += ((input.size - 1) << 1);
   if constexpr (null_terminated) {
-    output.data[2] = 0;
+    output.data[input.size << 1] = 0;
   }
+  // The kernel encodes a suffix of the input, going backward like the loop
+  // below; we encode the rest.
+  input.size -= EncodeHexadecimalSuffix(input.data, input.size, output.data);
+  // We want the result to start at |output.data[0]|.
+  output.data += ((input.size - 1) << 1);
   input.data += input.size - 1;
   for (std::uint8_t const* const input_rend = input.data - input.size;
        input.data != input_rend;
@@ -102,11 +106,21 @@ void HexadecimalEncoder<null_terminated>::Decode(Array<char const> input,
         &input.data[input.size] <= static_cast<void*>(output.data))
       << "bad overlap";
   CHECK_GE(output.size, input.size / 2) << "output too small";
+  // The kernel decodes a prefix of the input, going forward like the loop
+  // below; we decode the rest.
+  std::int64_t const decoded_size =
+      DecodeHexadecimalPrefix(input.data, input.size, output.data);
+  input.data += decoded_size;
+  input.size -= decoded_size;
+  output.data += decoded_size / 2;
   for (char const* const input_end = input.data + input.size;
        input.data != input_end;
        input.data += 2, ++output.data) {
-    *output.data = (hexadecimal_digits_to_nibble[*input.data] << 4) |
-                   hexadecimal_digits_to_nibble[*(input.data + 1)];
+    // Unsigned to avoid negative indices for the characters above 0x7F.
+    auto const high = static_cast<std::uint8_t>(input.data[0]);
+    auto const low = static_cast<std::uint8_t>(input.data[1]);
+    *output.data = (hexadecimal_digits_to_nibble[high] << 4) |
+                   hexadecimal_digits_to_nibble[low];
   }
 }
 
@@ -0,0 +1,82 @@
+﻿
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "base/jthread.hpp"
+#include "base/status.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_stoppable_thread_pool {
+
+// A bounded pool of threads for long-running background computations, such as
+// the prognostications of the vessels or the reanimation of an ephemeris.  Each
+// client has at most one pending function: scheduling a function replaces the
+// one that the client may have pending, as only the most recent request of a
+// client is worth executing.  The functions of a given client are never
+// executed concurrently.  When several functions are runnable, the one with the
+// highest priority is executed first, in FIFO order for equal priorities.  The
+// threads block on a condition until a function is scheduled, so an idle pool
+// consumes no CPU.  The functions are executed on stoppable threads, so they
+// may use |RETURN_IF_STOPPED| to notice that they have been cancelled.  This
+// class is thread-safe.
+class StoppableThreadPool final {
+ public:
+  explicit StoppableThreadPool(std::int64_t pool_size);
+
+  // Cancels the functions being executed and drops the pending ones.
+  ~StoppableThreadPool();
+
+  // Schedules |function| for execution on behalf of |client|, replacing the
+  // function that |client| may have pending.  If a function of |client| is
+  // being executed, |function| is executed after it completes.
+  void Schedule(void const* client,
+                std::int64_t priority,
+                std::function<void()> function);
+
+  // Drops the function that |client| may have pending and, if a function of
+  // |client| is being executed, requests it to stop and waits for its
+  // completion.  When this function returns, no function of |client| is being
+  // executed.
+  void Cancel(void const* client);
+
+  std::int64_t pool_size() const;
+
+ private:
+  struct Request {
+    std::int64_t priority;
+    std::int64_t sequence_number;
+    std::function<void()> function;
+  };
+  using Requests = std::map<void const*, Request>;
+
+  // Returns the pending request with the highest priority whose client is not
+  // being executed, or |pending_.end()| if there is none.
+  Requests::iterator FindRunnable() EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // The loop executed by the thread at |index| in |threads_|.  Returns when the
+  // pool is destroyed or when the thread is stopped by |Cancel|.
+  Status Work(std::int64_t index);
+
+  mutable absl::Mutex lock_;
+  Requests pending_ GUARDED_BY(lock_);
+  // The index in |threads_| of the thread executing each client.
+  std::map<void const*, std::int64_t> running_ GUARDED_BY(lock_);
+  std::int64_t next_sequence_number_ GUARDED_BY(lock_) = 0;
+  bool shutdown_ GUARDED_BY(lock_) = false;
+  std::vector<jthread> threads_ GUARDED_BY(lock_);
+};
+
+}  // namespace internal_stoppable_thread_pool
+
+using internal_stoppable_thread_pool::StoppableThreadPool;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/stoppable_thread_pool_body.hpp"
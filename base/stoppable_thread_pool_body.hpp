@@ -0,0 +1,130 @@
+﻿
+#pragma once
+
+#include "base/stoppable_thread_pool.hpp"
+
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_stoppable_thread_pool {
+
+inline StoppableThreadPool::StoppableThreadPool(std::int64_t const pool_size) {
+  CHECK_LT(0, pool_size);
+  absl::MutexLock l(&lock_);
+  for (std::int64_t i = 0; i < pool_size; ++i) {
+    threads_.push_back(MakeStoppableThread([this, i]() { Work(i); }));
+  }
+}
+
+inline StoppableThreadPool::~StoppableThreadPool() {
+  std::vector<jthread> threads;
+  {
+    absl::MutexLock l(&lock_);
+    shutdown_ = true;
+    pending_.clear();
+    for (auto& thread : threads_) {
+      thread.request_stop();
+    }
+    threads.swap(threads_);
+  }
+  // The threads are joined here, without holding the lock, since they need it
+  // to notice the shutdown.
+}
+
+inline void StoppableThreadPool::Schedule(void const* const client,
+                                          std::int64_t const priority,
+                                          std::function<void()> function) {
+  absl::MutexLock l(&lock_);
+  pending_.insert_or_assign(
+      client,
+      Request{priority, next_sequence_number_++, std::move(function)});
+}
+
+inline void StoppableThreadPool::Cancel(void const* const client) {
+  jthread stopped_thread;
+  {
+    absl::MutexLock l(&lock_);
+    pending_.erase(client);
+    auto const it = running_.find(client);
+    if (it == running_.end()) {
+      return;
+    }
+
+    // Stop the thread that executes |client| and wait until it's done with it.
+    // The thread exits its loop once the function returns, so it must be
+    // replaced to keep the size of the pool constant.
+    std::int64_t const index = it->second;
+    threads_[index].request_stop();
+    auto const client_is_done = [this, client]() {
+      return running_.count(client) == 0;
+    };
+    lock_.Await(absl::Condition(&client_is_done));
+    stopped_thread = std::move(threads_[index]);
+    threads_[index] = MakeStoppableThread([this, index]() { Work(index); });
+  }
+  // |stopped_thread| is joined here, without holding the lock.
+}
+
+inline std::int64_t StoppableThreadPool::pool_size() const {
+  absl::MutexLock l(&lock_);
+  return threads_.size();
+}
+
+inline StoppableThreadPool::Requests::iterator
+StoppableThreadPool::FindRunnable() {
+  auto runnable = pending_.end();
+  for (auto it = pending_.begin(); it != pending_.end(); ++it) {
+    auto const& [client, request] = *it;
+    if (running_.count(client) > 0) {
+      continue;
+    }
+    if (runnable == pending_.end() ||
+        request.priority > runnable->second.priority ||
+        (request.priority == runnable->second.priority &&
+         request.sequence_number < runnable->second.sequence_number)) {
+      runnable = it;
+    }
+  }
+  return runnable;
+}
+
+inline Status StoppableThreadPool::Work(std::int64_t const index) {
+  for (;;) {
+    void const* client;
+    std::function<void()> function;
+    {
+      absl::MutexLock l(&lock_);
+      auto const has_runnable_or_shutdown = [this]() {
+        return shutdown_ || FindRunnable() != pending_.end();
+      };
+      lock_.Await(absl::Condition(&has_runnable_or_shutdown));
+      if (shutdown_) {
+        return Status::OK;
+      }
+      auto const it = FindRunnable();
+      client = it->first;
+      function = std::move(it->second.function);
+      pending_.erase(it);
+      running_.emplace(client, index);
+    }
+
+    // Execute the function without holding the lock as it might take some
+    // time.
+    function();
+    // Destroy the function before the client may be destroyed.
+    function = nullptr;
+
+    {
+      absl::MutexLock l(&lock_);
+      running_.erase(client);
+    }
+    RETURN_IF_STOPPED;
+  }
+}
+
+}  // namespace internal_stoppable_thread_pool
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,106 @@
+﻿
+#include "base/stoppable_thread_pool.hpp"
+
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "absl/synchronization/notification.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::ElementsAre;
+
+class StoppableThreadPoolTest : public ::testing::Test {
+ protected:
+  // Blocks the only thread of |pool_| until |release_| is notified.
+  void BlockPool() {
+    pool_.Schedule(&blocker_, /*priority=*/0, [this]() {
+      started_.Notify();
+      release_.WaitForNotification();
+    });
+    started_.WaitForNotification();
+  }
+
+  // Records in |executed_| the execution of the function of |client|.
+  std::function<void()> Record(int const client) {
+    return [this, client]() {
+      absl::MutexLock l(&lock_);
+      executed_.push_back(client);
+    };
+  }
+
+  StoppableThreadPool pool_{1};
+  int const blocker_ = 0;
+  absl::Notification started_;
+  absl::Notification release_;
+
+  absl::Mutex lock_;
+  std::vector<int> executed_ GUARDED_BY(lock_);
+};
+
+TEST_F(StoppableThreadPoolTest, Priority) {
+  int const clients[3] = {};
+  BlockPool();
+  pool_.Schedule(&clients[0], /*priority=*/0, Record(0));
+  pool_.Schedule(&clients[1], /*priority=*/2, Record(1));
+  pool_.Schedule(&clients[2], /*priority=*/1, Record(2));
+  release_.Notify();
+
+  absl::MutexLock l(&lock_);
+  auto const all_executed = [this]() {
+    return executed_.size() == 3;
+  };
+  lock_.Await(absl::Condition(&all_executed));
+  EXPECT_THAT(executed_, ElementsAre(1, 2, 0));
+}
+
+TEST_F(StoppableThreadPoolTest, Replacement) {
+  int const clients[2] = {};
+  BlockPool();
+  pool_.Schedule(&clients[0], /*priority=*/0, Record(0));
+  pool_.Schedule(&clients[1], /*priority=*/0, Record(1));
+  pool_.Schedule(&clients[0], /*priority=*/0, Record(2));
+  pool_.Cancel(&clients[1]);
+  release_.Notify();
+
+  absl::MutexLock l(&lock_);
+  auto const executed = [this]() {
+    return !executed_.empty();
+  };
+  lock_.Await(absl::Condition(&executed));
+  EXPECT_THAT(executed_, ElementsAre(2));
+}
+
+TEST_F(StoppableThreadPoolTest, Cancel) {
+  int const client = 0;
+  absl::Notification running;
+  bool stopped = false;
+  pool_.Schedule(&client, /*priority=*/0, [&running, &stopped]() {
+    running.Notify();
+    while (!this_stoppable_thread::get_stop_token().stop_requested()) {
+      std::this_thread::yield();
+    }
+    stopped = true;
+  });
+  running.WaitForNotification();
+  pool_.Cancel(&client);
+  EXPECT_TRUE(stopped);
+
+  // The stopped thread has been replaced.
+  EXPECT_EQ(1, pool_.pool_size());
+  pool_.Schedule(&client, /*priority=*/0, Record(3));
+  absl::MutexLock l(&lock_);
+  auto const executed = [this]() {
+    return !executed_.empty();
+  };
+  lock_.Await(absl::Condition(&executed));
+  EXPECT_THAT(executed_, ElementsAre(3));
+}
+
+}  // namespace base
+}  // namespace principia
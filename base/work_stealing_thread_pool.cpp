@@ -0,0 +1,181 @@
+#include "base/work_stealing_thread_pool.hpp"
+
+#include <utility>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace base {
+namespace internal_work_stealing_thread_pool {
+
+thread_local WorkStealingThreadPool const*
+    WorkStealingThreadPool::current_pool_ = nullptr;
+thread_local std::int64_t WorkStealingThreadPool::current_worker_index_ =
+    WorkStealingThreadPool::no_worker;
+
+WorkStealingThreadPool::WorkStealingThreadPool(std::int64_t const pool_size) {
+  CHECK_LT(0, pool_size);
+  for (std::int64_t i = 0; i < pool_size; ++i) {
+    workers_.push_back(std::make_unique<Worker>());
+  }
+  // The workers must all exist before the first thread starts stealing.
+  for (std::int64_t i = 0; i < pool_size; ++i) {
+    threads_.emplace_back(&WorkStealingThreadPool::Work, this, i);
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    absl::MutexLock l(&sleep_lock_);
+    shutdown_ = true;
+  }
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+}
+
+std::int64_t WorkStealingThreadPool::pool_size() const {
+  return workers_.size();
+}
+
+void WorkStealingThreadPool::Push(Call call) {
+  std::int64_t index = CurrentWorkerIndex();
+  if (index == no_worker) {
+    index = next_worker_++ % pool_size();
+  }
+  Worker& worker = *workers_[index];
+  {
+    absl::MutexLock l(&worker.lock);
+    worker.calls.push_back(std::move(call));
+    ++worker.size;
+  }
+  ++queued_calls_;
+
+  // Only take the lock if some thread may be sleeping.  A thread increments
+  // |sleeping_workers_| before checking |queued_calls_|, and we do the
+  // opposite, so at least one of us sees the increment of the other.
+  if (sleeping_workers_ > 0) {
+    absl::MutexLock l(&sleep_lock_);
+  }
+}
+
+bool WorkStealingThreadPool::TryExecuteOneCall() {
+  if (queued_calls_ <= 0) {
+    return false;
+  }
+
+  std::optional<Call> call;
+  std::int64_t const self = CurrentWorkerIndex();
+  if (self != no_worker) {
+    Worker& worker = *workers_[self];
+    if (worker.size > 0) {
+      absl::MutexLock l(&worker.lock);
+      if (!worker.calls.empty()) {
+        call = std::move(worker.calls.back());
+        worker.calls.pop_back();
+        --worker.size;
+      }
+    }
+  }
+
+  if (!call.has_value()) {
+    std::int64_t const first_victim =
+        self == no_worker ? next_worker_++ : self + 1;
+    for (std::int64_t i = 0; i < pool_size() && !call.has_value(); ++i) {
+      std::int64_t const victim_index = (first_victim + i) % pool_size();
+      if (victim_index == self) {
+        continue;
+      }
+      Worker& victim = *workers_[victim_index];
+      if (victim.size > 0) {
+        absl::MutexLock l(&victim.lock);
+        if (!victim.calls.empty()) {
+          call = std::move(victim.calls.front());
+          victim.calls.pop_front();
+          --victim.size;
+        }
+      }
+    }
+  }
+
+  if (!call.has_value()) {
+    return false;
+  }
+  --queued_calls_;
+
+  // Execute the function without holding any lock as it might take some time.
+  (*call)();
+  return true;
+}
+
+std::int64_t WorkStealingThreadPool::CurrentWorkerIndex() const {
+  return current_pool_ == this ? current_worker_index_ : no_worker;
+}
+
+void WorkStealingThreadPool::WaitUntilDone(std::atomic<bool> const& done) {
+  if (CurrentWorkerIndex() == no_worker) {
+    BlockUntilDone(done);
+  } else {
+    // Blocking here could deadlock if the call that we are waiting for is in
+    // the deque of this thread, so help instead.  Once the deques are empty,
+    // that call is executing on another thread: sleep like an idle worker
+    // until either it completes or a call is pushed.
+    while (!done) {
+      if (TryExecuteOneCall()) {
+        continue;
+      }
+      absl::MutexLock l(&sleep_lock_);
+      ++sleeping_workers_;
+      auto const is_done_or_has_calls = [this, &done]() -> bool {
+        return done || queued_calls_ > 0;
+      };
+      sleep_lock_.Await(absl::Condition(&is_done_or_has_calls));
+      --sleeping_workers_;
+    }
+  }
+}
+
+void WorkStealingThreadPool::BlockUntilDone(std::atomic<bool> const& done) {
+  absl::MutexLock l(&done_lock_);
+  ++blocked_waiters_;
+  auto const is_done = [&done]() -> bool { return done; };
+  done_lock_.Await(absl::Condition(&is_done));
+  --blocked_waiters_;
+}
+
+void WorkStealingThreadPool::NotifyDone() {
+  // Same protocol as for |sleeping_workers_| in |Push|.  The threads of the
+  // pool that wait for a task sleep on |sleep_lock_|.
+  if (blocked_waiters_ > 0) {
+    absl::MutexLock l(&done_lock_);
+  }
+  if (sleeping_workers_ > 0) {
+    absl::MutexLock l(&sleep_lock_);
+  }
+}
+
+void WorkStealingThreadPool::Work(std::int64_t const index) {
+  current_pool_ = this;
+  current_worker_index_ = index;
+  for (;;) {
+    if (TryExecuteOneCall()) {
+      continue;
+    }
+    if (shutdown_) {
+      break;
+    }
+
+    // Wait until either a call is pushed or this class is shutting down.
+    absl::MutexLock l(&sleep_lock_);
+    ++sleeping_workers_;
+    auto const has_calls_or_shutdown = [this]() {
+      return shutdown_ || queued_calls_ > 0;
+    };
+    sleep_lock_.Await(absl::Condition(&has_calls_or_shutdown));
+    --sleeping_workers_;
+  }
+}
+
+}  // namespace internal_work_stealing_thread_pool
+}  // namespace base
+}  // namespace principia
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <memory>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+#include "absl/synchronization/mutex.h"
+#include "base/function.hpp"
+
+namespace principia {
+namespace base {
+namespace internal_work_stealing_thread_pool {
+
+class WorkStealingThreadPool;
+
+// The state shared between a |Task| and the call that computes its result.
+// There is no synchronization object per task: threads that need to block wait
+// on a lock of the pool.
+template<typename T>
+struct TaskState {
+  std::atomic<bool> done = false;
+  std::optional<T> value;
+};
+
+template<>
+struct TaskState<void> {
+  std::atomic<bool> done = false;
+};
+
+// A handle to the result of a function added to a |WorkStealingThreadPool|.
+// This is lighter than a |std::future|: there is no promise, the result is
+// stored in place in the state shared with the call.
+template<typename T>
+class Task final {
+ public:
+  Task() = default;
+
+  // Returns true iff the function has completed.
+  bool ready() const;
+
+  // Blocks until the function has completed.  If called from a thread of the
+  // pool, that thread executes other calls while it waits, so that nested
+  // tasks cannot deadlock.
+  void Wait() const;
+
+  // Waits for the function to complete and returns its result.  May be called
+  // at most once.
+  T Get();
+
+ private:
+  Task(WorkStealingThreadPool* pool, std::shared_ptr<TaskState<T>> state);
+
+  WorkStealingThreadPool* pool_ = nullptr;
+  std::shared_ptr<TaskState<T>> state_;
+
+  friend class WorkStealingThreadPool;
+};
+
+// A pool of threads that are created at construction and to which functions can
+// be added for asynchronous execution.  Each thread has its own deque of calls:
+// it pushes the calls that it creates at the back of its deque and executes
+// them in LIFO order; when its deque is empty, it steals calls from the front
+// of the deques of the other threads.  The calls added from outside of the pool
+// are distributed among the threads.  Compared to |ThreadPool|, this avoids
+// contention on a single queue when many short calls are added, and supports
+// nested parallelism: a call may add calls, wait for tasks, or execute a
+// |ParallelFor|.  This class is thread-safe.
+class WorkStealingThreadPool final {
+ public:
+  // Constructs a pool with the given number of threads.
+  explicit WorkStealingThreadPool(std::int64_t pool_size);
+
+  // Waits for the completion of the calls already added.
+  ~WorkStealingThreadPool();
+
+  // Adds a call to |function| for asynchronous execution, and returns a task
+  // that the client may use to wait until execution has completed and to
+  // extract the result.
+  template<typename Function>
+  Task<std::invoke_result_t<Function>> Add(Function function);
+
+  // Calls |body(i)| for each |i| in [begin, end[ in parallel, and returns when
+  // all the calls have completed.  The calling thread participates in the
+  // execution but, unlike |Task::Wait|, it never executes unrelated calls, so
+  // |ParallelFor| may be called with locks held that other calls of this pool
+  // take.  The range is split in chunks of at least |grain_size| indices.  May
+  // be called from within a call executing on this pool.
+  template<typename Body>
+  void ParallelFor(std::int64_t begin,
+                   std::int64_t end,
+                   Body const& body,
+                   std::int64_t grain_size = 1);
+
+  std::int64_t pool_size() const;
+
+ private:
+  using Call = function<void()>;
+
+  struct Worker {
+    absl::Mutex lock;
+    std::deque<Call> calls GUARDED_BY(lock);
+    // The size of |calls|, readable without locking so that thieves don't
+    // lock the workers that have nothing to steal.
+    std::atomic<std::int64_t> size = 0;
+  };
+
+  static constexpr std::int64_t no_worker = -1;
+
+  // Pushes |call| at the back of the deque of the current thread if it belongs
+  // to this pool, or at the back of the deque of some worker otherwise.
+  void Push(Call call);
+
+  // Executes one call, taken from the back of the deque of the current thread
+  // if it belongs to this pool, or stolen from the front of the deque of
+  // another worker.  Returns false if there was no call to execute.
+  bool TryExecuteOneCall();
+
+  // Returns the index of the current thread in |workers_|, or |no_worker| if
+  // the current thread doesn't belong to this pool.
+  std::int64_t CurrentWorkerIndex() const;
+
+  // Returns when |done| becomes true.  A thread of this pool executes other
+  // calls while it waits, and blocks when there are none left; a thread
+  // outside of the pool blocks.
+  void WaitUntilDone(std::atomic<bool> const& done);
+
+  // Blocks until |done| becomes true, without executing any call.
+  void BlockUntilDone(std::atomic<bool> const& done);
+
+  // Must be called after setting a |done| flag, to wake up the threads blocked
+  // in |WaitUntilDone|.
+  void NotifyDone();
+
+  // The loop executed by the thread at |index|.
+  void Work(std::int64_t index);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+
+  // Used to distribute the calls added from outside of the pool and to spread
+  // the stealing done by threads that don't belong to the pool.
+  std::atomic<std::int64_t> next_worker_ = 0;
+
+  // The total number of calls in the deques.  May be transiently negative, as
+  // a call may be popped before the increment that follows its push.
+  std::atomic<std::int64_t> queued_calls_ = 0;
+
+  // Idle threads, and threads of the pool that wait for a task with nothing
+  // left to execute, sleep on this lock, which is only taken to wake them up.
+  absl::Mutex sleep_lock_;
+  std::atomic<std::int64_t> sleeping_workers_ = 0;
+  std::atomic<bool> shutdown_ = false;
+
+  // Threads outside of the pool that wait for a task, and threads that wait
+  // for the end of a |ParallelFor|, block on this lock, which is only taken to
+  // wake them up.
+  absl::Mutex done_lock_;
+  std::atomic<std::int64_t> blocked_waiters_ = 0;
+
+  std::list<std::thread> threads_;
+
+  // The pool and the index in |workers_| of the current thread, if it belongs
+  // to a pool.
+  static thread_local WorkStealingThreadPool const* current_pool_;
+  static thread_local std::int64_t current_worker_index_;
+
+  template<typename T>
+  friend class Task;
+};
+
+}  // namespace internal_work_stealing_thread_pool
+
+using internal_work_stealing_thread_pool::Task;
+using internal_work_stealing_thread_pool::WorkStealingThreadPool;
+
+}  // namespace base
+}  // namespace principia
+
+#include "base/work_stealing_thread_pool_body.hpp"
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "base/work_stealing_thread_pool.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <utility>
+
+namespace principia {
+namespace base {
+namespace internal_work_stealing_thread_pool {
+
+// A helper function that special-cases void because void is not really a
+// type.
+template<typename T, typename Function>
+void ExecuteAndSetValue(Function& function, TaskState<T>& state) {
+  if constexpr (std::is_void_v<T>) {
+    function();
+  } else {
+    state.value.emplace(function());
+  }
+  state.done = true;
+}
+
+template<typename T>
+bool Task<T>::ready() const {
+  return state_->done;
+}
+
+template<typename T>
+void Task<T>::Wait() const {
+  pool_->WaitUntilDone(state_->done);
+}
+
+template<typename T>
+T Task<T>::Get() {
+  Wait();
+  if constexpr (!std::is_void_v<T>) {
+    return std::move(*state_->value);
+  }
+}
+
+template<typename T>
+Task<T>::Task(WorkStealingThreadPool* const pool,
+              std::shared_ptr<TaskState<T>> state)
+    : pool_(pool),
+      state_(std::move(state)) {}
+
+template<typename Function>
+Task<std::invoke_result_t<Function>> WorkStealingThreadPool::Add(
+    Function function) {
+  using T = std::invoke_result_t<Function>;
+  auto state = std::make_shared<TaskState<T>>();
+  Push([this, function = std::move(function), state]() mutable {
+    ExecuteAndSetValue(function, *state);
+    NotifyDone();
+  });
+  return Task<T>(this, std::move(state));
+}
+
+template<typename Body>
+void WorkStealingThreadPool::ParallelFor(std::int64_t const begin,
+                                         std::int64_t const end,
+                                         Body const& body,
+                                         std::int64_t const grain_size) {
+  std::int64_t const size = end - begin;
+  if (size <= 0) {
+    return;
+  }
+
+  // A few chunks per thread, so that stealing can even out the load if the
+  // iterations have different costs.
+  std::int64_t const chunks_per_thread = 4;
+  std::int64_t const chunk_size =
+      std::max(grain_size,
+               (size + chunks_per_thread * pool_size() - 1) /
+                   (chunks_per_thread * pool_size()));
+  std::int64_t const number_of_chunks = (size + chunk_size - 1) / chunk_size;
+
+  auto const execute_chunk = [begin, end, chunk_size, &body](
+                                 std::int64_t const chunk) {
+    std::int64_t const chunk_begin = begin + chunk * chunk_size;
+    std::int64_t const chunk_end = std::min(end, chunk_begin + chunk_size);
+    for (std::int64_t i = chunk_begin; i < chunk_end; ++i) {
+      body(i);
+    }
+  };
+
+  // The chunks are claimed in order by the calls pushed below and by this
+  // thread, which starts with the first one.  The state is shared with the
+  // calls because those that find no chunk left may execute after this
+  // function has returned; they don't access |body| or |execute_chunk| then.
+  // The calls copy |complete_chunk| because the last of them may still be
+  // executing it when this function returns.
+  struct State {
+    std::atomic<std::int64_t> next_chunk = 1;
+    std::atomic<std::int64_t> remaining_chunks;
+    std::atomic<bool> done = false;
+  };
+  auto const state = std::make_shared<State>();
+  state->remaining_chunks = number_of_chunks;
+  auto const complete_chunk = [this](State& state) {
+    if (--state.remaining_chunks == 0) {
+      state.done = true;
+      NotifyDone();
+    }
+  };
+  for (std::int64_t i = 1; i < number_of_chunks; ++i) {
+    Push([number_of_chunks, state, complete_chunk, &execute_chunk]() {
+      std::int64_t const chunk = state->next_chunk++;
+      if (chunk < number_of_chunks) {
+        execute_chunk(chunk);
+        complete_chunk(*state);
+      }
+    });
+  }
+
+  // This thread only executes chunks of this loop, never other calls of the
+  // pool, which may need locks that the caller holds.  Once all the chunks
+  // have been claimed, it blocks until those executed by other threads have
+  // completed; this cannot deadlock since they are already executing.
+  execute_chunk(0);
+  complete_chunk(*state);
+  for (std::int64_t chunk = state->next_chunk++;
+       chunk < number_of_chunks;
+       chunk = state->next_chunk++) {
+    execute_chunk(chunk);
+    complete_chunk(*state);
+  }
+  BlockUntilDone(state->done);
+}
+
+}  // namespace internal_work_stealing_thread_pool
+}  // namespace base
+}  // namespace principia
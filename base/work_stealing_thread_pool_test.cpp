@@ -0,0 +1,185 @@
+#include "base/work_stealing_thread_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "absl/synchronization/mutex.h"
+#include "glog/logging.h"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+namespace principia {
+namespace base {
+
+using ::testing::ElementsAre;
+
+class WorkStealingThreadPoolTest : public ::testing::Test {
+ protected:
+  WorkStealingThreadPoolTest() : pool_(std::thread::hardware_concurrency()) {
+    LOG(ERROR) << "Concurrency is " << std::thread::hardware_concurrency();
+  }
+
+  WorkStealingThreadPool pool_;
+};
+
+// Check that execution occurs in parallel.  If things were sequential, the
+// integers in |numbers| would be monotonically increasing.
+TEST_F(WorkStealingThreadPoolTest, ParallelExecution) {
+#if defined(_DEBUG)
+  constexpr int number_of_calls = 100'000;
+#else
+  constexpr int number_of_calls = 1'000'000;
+#endif
+
+  absl::Mutex lock;
+  std::vector<std::int64_t> numbers;
+  std::vector<Task<void>> tasks;
+  for (std::int64_t i = 0; i < number_of_calls; ++i) {
+    tasks.push_back(pool_.Add([i, &lock, &numbers]() {
+      absl::MutexLock l(&lock);
+      numbers.push_back(i);
+    }));
+  }
+
+  for (auto const& task : tasks) {
+    task.Wait();
+  }
+
+  EXPECT_EQ(number_of_calls, numbers.size());
+  bool monotonically_increasing = true;
+  for (std::int64_t i = 1; i < numbers.size(); ++i) {
+    if (numbers[i] < numbers[i - 1]) {
+      monotonically_increasing = false;
+    }
+  }
+  EXPECT_FALSE(monotonically_increasing);
+}
+
+TEST_F(WorkStealingThreadPoolTest, Results) {
+  std::vector<Task<std::int64_t>> tasks;
+  for (std::int64_t i = 0; i < 1000; ++i) {
+    tasks.push_back(pool_.Add([i]() { return i * i; }));
+  }
+  for (std::int64_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(i * i, tasks[i].Get());
+    EXPECT_TRUE(tasks[i].ready());
+  }
+}
+
+// Tasks that wait for tasks that they create must not deadlock, even on a pool
+// with a single thread.
+TEST(WorkStealingThreadPoolNestingTest, NestedTasks) {
+  WorkStealingThreadPool pool(/*pool_size=*/1);
+  auto task = pool.Add([&pool]() {
+    std::int64_t sum = 0;
+    std::vector<Task<std::int64_t>> inner_tasks;
+    for (std::int64_t i = 0; i < 10; ++i) {
+      inner_tasks.push_back(pool.Add([i]() { return i; }));
+    }
+    for (auto& inner_task : inner_tasks) {
+      sum += inner_task.Get();
+    }
+    return sum;
+  });
+  EXPECT_EQ(45, task.Get());
+}
+
+TEST_F(WorkStealingThreadPoolTest, ParallelFor) {
+  std::vector<std::int64_t> squares(10'000);
+  pool_.ParallelFor(0, squares.size(), [&squares](std::int64_t const i) {
+    squares[i] = i * i;
+  });
+  for (std::int64_t i = 0; i < squares.size(); ++i) {
+    EXPECT_EQ(i * i, squares[i]);
+  }
+
+  // An empty range.
+  pool_.ParallelFor(3, 3, [](std::int64_t const i) { FAIL(); });
+
+  // A large grain size.
+  std::vector<std::int64_t> visited;
+  pool_.ParallelFor(
+      5, 8,
+      [&visited](std::int64_t const i) { visited.push_back(i); },
+      /*grain_size=*/100);
+  EXPECT_THAT(visited, ElementsAre(5, 6, 7));
+}
+
+// A thread outside of the pool that runs out of chunks to execute blocks
+// until the chunks executed by the pool have completed.
+TEST(WorkStealingThreadPoolNestingTest, ParallelForFromOutside) {
+  WorkStealingThreadPool pool(/*pool_size=*/2);
+  std::atomic<bool> started = false;
+  std::atomic<bool> completed = false;
+  pool.ParallelFor(0, 2, [&started, &completed](std::int64_t const i) {
+    if (i == 0) {
+      // Make sure that the other chunk is executed by the pool.
+      while (!started) {
+        std::this_thread::yield();
+      }
+    } else {
+      started = true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      completed = true;
+    }
+  });
+  EXPECT_TRUE(completed);
+}
+
+TEST_F(WorkStealingThreadPoolTest, NestedParallelFor) {
+  constexpr std::int64_t outer = 100;
+  constexpr std::int64_t inner = 1000;
+  std::vector<std::atomic<std::int64_t>> sums(outer);
+  pool_.ParallelFor(0, outer, [this, &sums](std::int64_t const i) {
+    pool_.ParallelFor(0, inner, [i, &sums](std::int64_t const j) {
+      sums[i] += j;
+    });
+  });
+  for (auto const& sum : sums) {
+    EXPECT_EQ(inner * (inner - 1) / 2, sum);
+  }
+}
+
+// A |ParallelFor| executed with a lock held must not execute other calls that
+// take that lock, even when it runs out of chunks while another thread still
+// executes one.
+TEST(WorkStealingThreadPoolNestingTest, ParallelForWithLockHeld) {
+  WorkStealingThreadPool pool(/*pool_size=*/2);
+  absl::Mutex lock;
+  Task<void> other_task;
+  auto task = pool.Add([&lock, &other_task, &pool]() {
+    absl::MutexLock l(&lock);
+    std::atomic<bool> started = false;
+    pool.ParallelFor(0, 2, [&lock, &other_task, &pool, &started](
+                               std::int64_t const i) {
+      if (i == 0) {
+        // Make sure that the other chunk is executed by the other thread.
+        while (!started) {
+          std::this_thread::yield();
+        }
+      } else {
+        other_task = pool.Add([&lock]() { absl::MutexLock l(&lock); });
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      }
+    });
+  });
+  task.Wait();
+  other_task.Wait();
+}
+
+TEST(WorkStealingThreadPoolNestingTest, DestructionCompletesCalls) {
+  std::atomic<std::int64_t> count = 0;
+  {
+    WorkStealingThreadPool pool(/*pool_size=*/4);
+    for (std::int64_t i = 0; i < 1000; ++i) {
+      pool.Add([&count]() { ++count; });
+    }
+  }
+  EXPECT_EQ(1000, count);
+}
+
+}  // namespace base
+}  // namespace principia
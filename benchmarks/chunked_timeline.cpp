@@ -0,0 +1,159 @@
+// .\Release\x64\benchmarks.exe --benchmark_filter=Timeline
+
+// Compares the |ChunkedTimeline| used by |DiscreteTrajectory| with the
+// |std::map| that it replaced, for memory usage and locality.
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "geometry/named_quantities.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "physics/chunked_timeline.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "quantities/si.hpp"
+
+namespace {
+// The number and total size of the allocations performed by the process.
+// This is a bit intrusive, but it's the only way to account for the memory
+// used by the containers without instrumenting them.
+std::atomic<std::int64_t> allocations = 0;
+std::atomic<std::int64_t> allocated_bytes = 0;
+}  // namespace
+
+void* operator new(std::size_t const size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  if (void* const p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* const p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* const p, std::size_t) noexcept {
+  std::free(p);
+}
+
+namespace principia {
+namespace physics {
+
+using geometry::Instant;
+using ksp_plugin::World;
+using quantities::si::Second;
+
+using MapTimeline = std::map<Instant, DegreesOfFreedom<World>>;
+using ChunkTimeline = ChunkedTimeline<DegreesOfFreedom<World>>;
+
+namespace {
+
+DegreesOfFreedom<World> const degrees_of_freedom = {World::origin,
+                                                    World::unmoving};
+
+// Fills |timelines| round-robin, so that their allocations are interleaved,
+// like those of the histories of the vessels, which are all prolonged at each
+// step.
+template<typename Timeline>
+void FillRoundRobin(std::vector<std::unique_ptr<Timeline>>& timelines,
+                    int const steps_per_timeline) {
+  Instant t;
+  for (int i = 0; i < steps_per_timeline; ++i, t += 1 * Second) {
+    for (auto const& timeline : timelines) {
+      timeline->emplace_hint(timeline->end(), t, degrees_of_freedom);
+    }
+  }
+}
+
+}  // namespace
+
+// Reports the number of allocations and the number of bytes allocated per
+// point when appending |state.range(0)| points.
+template<typename Timeline>
+void BM_TimelineAppend(benchmark::State& state) {
+  int const steps = state.range(0);
+  std::int64_t total_allocations = 0;
+  std::int64_t total_allocated_bytes = 0;
+  for (auto _ : state) {
+    auto timeline = std::make_unique<Timeline>();
+    std::int64_t const allocations_before = allocations;
+    std::int64_t const allocated_bytes_before = allocated_bytes;
+    Instant t;
+    for (int i = 0; i < steps; ++i, t += 1 * Second) {
+      timeline->emplace_hint(timeline->end(), t, degrees_of_freedom);
+    }
+    total_allocations += allocations - allocations_before;
+    total_allocated_bytes += allocated_bytes - allocated_bytes_before;
+    // Destroy outside of the timing.
+    state.PauseTiming();
+    timeline.reset();
+    state.ResumeTiming();
+  }
+  double const points = static_cast<double>(state.iterations()) * steps;
+  state.counters["allocations/point"] = total_allocations / points;
+  state.counters["bytes/point"] = total_allocated_bytes / points;
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+// Iterates over |state.range(0)| points spread over 64 timelines that were
+// filled round-robin.
+template<typename Timeline>
+void BM_TimelineIterate(benchmark::State& state) {
+  int const steps = state.range(0);
+  constexpr int timeline_count = 64;
+  std::vector<std::unique_ptr<Timeline>> timelines;
+  for (int i = 0; i < timeline_count; ++i) {
+    timelines.push_back(std::make_unique<Timeline>());
+  }
+  FillRoundRobin(timelines, steps / timeline_count);
+
+  for (auto _ : state) {
+    for (auto const& timeline : timelines) {
+      for (auto const& [time, degrees_of_freedom] : *timeline) {
+        benchmark::DoNotOptimize(degrees_of_freedom);
+      }
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
+// Appends points and forgets the oldest ones, keeping |state.range(0)| points,
+// as happens for histories with |ForgetBefore|.
+template<typename Timeline>
+void BM_TimelineAppendAndForgetBefore(benchmark::State& state) {
+  int const steps = state.range(0);
+  constexpr int steps_per_forget = 1'000;
+  Timeline timeline;
+  Instant t;
+  for (int i = 0; i < steps; ++i, t += 1 * Second) {
+    timeline.emplace_hint(timeline.end(), t, degrees_of_freedom);
+  }
+
+  for (auto _ : state) {
+    for (int i = 0; i < steps_per_forget; ++i, t += 1 * Second) {
+      timeline.emplace_hint(timeline.end(), t, degrees_of_freedom);
+    }
+    timeline.erase(timeline.begin(),
+                   timeline.lower_bound(t - steps * Second));
+  }
+  state.SetItemsProcessed(state.iterations() * steps_per_forget);
+}
+
+BENCHMARK_TEMPLATE(BM_TimelineAppend, MapTimeline)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_TimelineAppend, ChunkTimeline)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_TimelineIterate, MapTimeline)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_TimelineIterate, ChunkTimeline)->Arg(1'000'000);
+BENCHMARK_TEMPLATE(BM_TimelineAppendAndForgetBefore, MapTimeline)
+    ->Arg(100'000);
+BENCHMARK_TEMPLATE(BM_TimelineAppendAndForgetBefore, ChunkTimeline)
+    ->Arg(100'000);
+
+}  // namespace physics
+}  // namespace principia
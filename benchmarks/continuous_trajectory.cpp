@@ -0,0 +1,147 @@
+﻿
+// .\Release\x64\benchmarks.exe --benchmark_repetitions=5 --benchmark_filter=ContinuousTrajectory  // NOLINT(whitespace/line_length)
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/not_null.hpp"
+#include "benchmark/benchmark.h"
+#include "geometry/named_quantities.hpp"
+#include "integrators/methods.hpp"
+#include "integrators/symmetric_linear_multistep_integrator.hpp"
+#include "ksp_plugin/frames.hpp"
+#include "physics/continuous_trajectory.hpp"
+#include "physics/degrees_of_freedom.hpp"
+#include "physics/ephemeris.hpp"
+#include "physics/solar_system.hpp"
+#include "quantities/astronomy.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+#include "testing_utilities/solar_system_factory.hpp"
+
+namespace principia {
+
+using base::make_not_null_unique;
+using base::not_null;
+using geometry::Instant;
+using geometry::Position;
+using integrators::SymmetricLinearMultistepIntegrator;
+using integrators::methods::QuinlanTremaine1990Order12;
+using ksp_plugin::Barycentric;
+using quantities::Time;
+using quantities::astronomy::JulianYear;
+using quantities::si::Metre;
+using quantities::si::Minute;
+using quantities::si::Second;
+using testing_utilities::SolarSystemFactory;
+
+namespace physics {
+
+namespace {
+
+// The ephemeris of the solar system is expensive to construct, so we share it
+// among all the benchmarks.
+class SolEphemeris {
+ public:
+  SolEphemeris()
+      : solar_system_(make_not_null_unique<SolarSystem<Barycentric>>(
+            SOLUTION_DIR / "astronomy" / "sol_gravity_model.proto.txt",
+            SOLUTION_DIR / "astronomy" /
+                "sol_initial_state_jd_2436145_604166667.proto.txt",
+            /*ignore_frame=*/true)) {
+    SolarSystemFactory::AdjustAccuracy(
+        SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness,
+        *solar_system_);
+    ephemeris_ = solar_system_->MakeEphemeris(
+        SolarSystemFactory::MakeAccuracyParameters<Barycentric>(
+            /*fitting_tolerance=*/5 * Metre,
+            SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness),
+        Ephemeris<Barycentric>::FixedStepParameters(
+            SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
+                                               Position<Barycentric>>(),
+            /*step=*/10 * Minute));
+    ephemeris_->Prolong(solar_system_->epoch() + 1 * JulianYear);
+  }
+
+  Instant t_min() const {
+    return solar_system_->epoch();
+  }
+
+  std::vector<not_null<ContinuousTrajectory<Barycentric> const*>>
+  trajectories() const {
+    std::vector<not_null<ContinuousTrajectory<Barycentric> const*>> result;
+    for (auto const body : ephemeris_->bodies()) {
+      result.push_back(ephemeris_->trajectory(body));
+    }
+    return result;
+  }
+
+ private:
+  not_null<std::unique_ptr<SolarSystem<Barycentric>>> const solar_system_;
+  std::unique_ptr<Ephemeris<Barycentric>> ephemeris_;
+};
+
+SolEphemeris const& Sol() {
+  static SolEphemeris const* const sol = new SolEphemeris;
+  return *sol;
+}
+
+}  // namespace
+
+// Evaluates the positions of all the bodies at successive times, which is the
+// access pattern of the ephemeris when flowing vessels.  The argument is the
+// time step in seconds.
+void BM_ContinuousTrajectoryEvaluatePosition(benchmark::State& state) {
+  Time const Δt = state.range(0) * Second;
+  auto const& sol = Sol();
+  auto const trajectories = sol.trajectories();
+  Instant const t_max = sol.t_min() + 1 * JulianYear;
+
+  Instant t = sol.t_min();
+  std::int64_t evaluations = 0;
+  for (auto _ : state) {
+    for (auto const trajectory : trajectories) {
+      benchmark::DoNotOptimize(trajectory->EvaluatePosition(t));
+    }
+    evaluations += trajectories.size();
+    t += Δt;
+    if (t > t_max) {
+      t = sol.t_min();
+    }
+  }
+  state.SetItemsProcessed(evaluations);
+}
+
+void BM_ContinuousTrajectoryEvaluateDegreesOfFreedom(benchmark::State& state) {
+  Time const Δt = state.range(0) * Second;
+  auto const& sol = Sol();
+  auto const trajectories = sol.trajectories();
+  Instant const t_max = sol.t_min() + 1 * JulianYear;
+
+  Instant t = sol.t_min();
+  std::int64_t evaluations = 0;
+  for (auto _ : state) {
+    for (auto const trajectory : trajectories) {
+      benchmark::DoNotOptimize(trajectory->EvaluateDegreesOfFreedom(t));
+    }
+    evaluations += trajectories.size();
+    t += Δt;
+    if (t > t_max) {
+      t = sol.t_min();
+    }
+  }
+  state.SetItemsProcessed(evaluations);
+}
+
+BENCHMARK(BM_ContinuousTrajectoryEvaluatePosition)
+    ->Arg(10)
+    ->Arg(600)
+    ->Arg(86'400);
+BENCHMARK(BM_ContinuousTrajectoryEvaluateDegreesOfFreedom)
+    ->Arg(10)
+    ->Arg(600)
+    ->Arg(86'400);
+
+}  // namespace physics
+}  // namespace principia
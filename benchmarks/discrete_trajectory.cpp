@@ -3,6 +3,8 @@
 
 #include "physics/discrete_trajectory.hpp"
 
+#include <memory>
+
 #include "base/not_null.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/frame.hpp"
@@ -101,6 +103,20 @@ void BM_DiscreteTrajectoryCreateDestroy(benchmark::State& state) {
   }
 }
 
+// Appends |state.range(0)| points to a trajectory, as happens for histories.
+void BM_DiscreteTrajectoryAppend(benchmark::State& state) {
+  int const steps = state.range(0);
+  for (auto _ : state) {
+    std::unique_ptr<DiscreteTrajectory<World>> trajectory =
+        CreateTrajectory(steps);
+    // Destroy outside of the timing.
+    state.PauseTiming();
+    trajectory.reset();
+    state.ResumeTiming();
+  }
+  state.SetItemsProcessed(state.iterations() * steps);
+}
+
 void BM_DiscreteTrajectoryIterate(benchmark::State& state) {
   int const steps = state.range(0);
   not_null<std::unique_ptr<DiscreteTrajectory<World>>> const trajectory =
@@ -112,6 +128,7 @@ void BM_DiscreteTrajectoryIterate(benchmark::State& state) {
     for (auto it = fork->begin(); it != fork->end(); ++it) {
     }
   }
+  state.SetItemsProcessed(state.iterations() * steps);
 }
 
 void BM_DiscreteTrajectoryReverseIterate(benchmark::State& state) {
@@ -162,7 +179,8 @@ BENCHMARK(BM_DiscreteTrajectoryBack);
 BENCHMARK(BM_DiscreteTrajectoryBegin);
 BENCHMARK(BM_DiscreteTrajectoryEnd);
 BENCHMARK(BM_DiscreteTrajectoryCreateDestroy)->Range(8, 1024);
-BENCHMARK(BM_DiscreteTrajectoryIterate)->Range(8, 1024);
+BENCHMARK(BM_DiscreteTrajectoryAppend)->Arg(1024)->Arg(1'000'000);
+BENCHMARK(BM_DiscreteTrajectoryIterate)->Range(8, 1024)->Arg(1'000'000);
 BENCHMARK(BM_DiscreteTrajectoryReverseIterate)->Range(8, 1024);
 BENCHMARK(BM_DiscreteTrajectoryFind)->Range(8, 1024);
 BENCHMARK(BM_DiscreteTrajectoryLowerBound)->Range(8, 1024);
@@ -88,17 +88,33 @@ ApplyDynamicFrame(
     not_null<Body const*> const body,
     not_null<DynamicFrame<Barycentric, Rendering>*> const dynamic_frame,
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
-    DiscreteTrajectory<Barycentric>::Iterator const& end) {
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    bool const batched) {
   std::vector<std::pair<Position<Barycentric>,
                         Position<Barycentric>>> result;
 
-  // Compute the trajectory in the rendering frame.
+  // Compute the trajectory in the rendering frame, either one point at a time
+  // or with a single batched evaluation of the frame.
   DiscreteTrajectory<Rendering> intermediate_trajectory;
-  for (auto it = begin; it != end; ++it) {
-    auto const& [time, degrees_of_freedom] = *it;
-    intermediate_trajectory.Append(
-        time,
-        dynamic_frame->ToThisFrameAtTime(time)(degrees_of_freedom));
+  if (batched) {
+    std::vector<Instant> times;
+    for (auto it = begin; it != end; ++it) {
+      times.push_back(it->time);
+    }
+    auto const rigid_motions = dynamic_frame->ToThisFrameAtTimes(times);
+    int i = 0;
+    for (auto it = begin; it != end; ++it, ++i) {
+      auto const& [time, degrees_of_freedom] = *it;
+      intermediate_trajectory.Append(time,
+                                     rigid_motions[i](degrees_of_freedom));
+    }
+  } else {
+    for (auto it = begin; it != end; ++it) {
+      auto const& [time, degrees_of_freedom] = *it;
+      intermediate_trajectory.Append(
+          time,
+          dynamic_frame->ToThisFrameAtTime(time)(degrees_of_freedom));
+    }
   }
 
   // Render the trajectory at current time in |Rendering|.
@@ -167,7 +183,8 @@ void BM_BodyCentredNonRotatingDynamicFrame(benchmark::State& state) {
     auto v = ApplyDynamicFrame(&probe,
                                &dynamic_frame,
                                probe_trajectory.begin(),
-                               probe_trajectory.end());
+                               probe_trajectory.end(),
+                               /*batched=*/state.range_y() != 0);
   }
 }
 
@@ -217,14 +234,20 @@ void BM_BarycentricRotatingDynamicFrame(benchmark::State& state) {
     auto v = ApplyDynamicFrame(&probe,
                                &dynamic_frame,
                                probe_trajectory.begin(),
-                               probe_trajectory.end());
+                               probe_trajectory.end(),
+                               /*batched=*/state.range_y() != 0);
   }
 }
 
 int const iterations = (1000 << 10) + 1;
 
-BENCHMARK(BM_BodyCentredNonRotatingDynamicFrame)->Arg(iterations);
-BENCHMARK(BM_BarycentricRotatingDynamicFrame)->Arg(iterations);
+// The second argument selects the batched evaluation of the frame.
+BENCHMARK(BM_BodyCentredNonRotatingDynamicFrame)
+    ->Args({iterations, 0})
+    ->Args({iterations, 1});
+BENCHMARK(BM_BarycentricRotatingDynamicFrame)
+    ->Args({iterations, 0})
+    ->Args({iterations, 1});
 
 }  // namespace physics
 }  // namespace principia
@@ -93,6 +93,33 @@ void BM_Decode(benchmark::State& state) {
   state.SetBytesProcessed(bytes_processed);
 }
 
+// Encodes and decodes |state.range(0)| bytes at once, like the saves and loads
+// of a large plugin.  The outputs are preallocated so that only the encoder is
+// measured.  The throughput is reported in bytes per second.
+template<typename Encoder>
+void BM_EncodeAndDecodeSave(benchmark::State& state) {
+  std::int64_t const size = state.range(0);
+
+  Encoder encoder;
+  std::mt19937_64 random(42);
+
+  UniqueArray<std::uint8_t> binary(size);
+  for (std::int64_t i = 0; i < binary.size; ++i) {
+    binary.data[i] = random();
+  }
+  UniqueArray<typename Encoder::Char> encoded(
+      encoder.EncodedLength(binary.get()));
+  UniqueArray<std::uint8_t> decoded(size);
+
+  for (auto _ : state) {
+    encoder.Encode(binary.get(), encoded.get());
+    encoder.Decode(encoded.get(), decoded.get());
+    benchmark::ClobberMemory();
+  }
+  CHECK(binary == decoded);
+  state.SetBytesProcessed(2 * state.iterations() * size);
+}
+
 using Encoder16 = HexadecimalEncoder</*null_terminated=*/false>;
 using Encoder64 = Base64Encoder</*null_terminated=*/false>;
 using Encoder32768 = Base32768Encoder</*null_terminated=*/false>;
@@ -101,6 +128,12 @@ BENCHMARK_TEMPLATE(BM_Encode, Encoder16);
 BENCHMARK_TEMPLATE(BM_Decode, Encoder16);
 BENCHMARK_TEMPLATE(BM_Encode, Encoder64);
 BENCHMARK_TEMPLATE(BM_Decode, Encoder64);
+BENCHMARK_TEMPLATE(BM_EncodeAndDecodeSave, Encoder16)
+    ->Arg(256 << 20)
+    ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_EncodeAndDecodeSave, Encoder64)
+    ->Arg(256 << 20)
+    ->Unit(benchmark::kMillisecond);
 #if !PRINCIPIA_COMPILER_MSVC || \
     !(_MSC_FULL_VER == 191'526'608 || \
       _MSC_FULL_VER == 191'526'731 || \
@@ -110,6 +143,9 @@ BENCHMARK_TEMPLATE(BM_Decode, Encoder64);
       _MSC_FULL_VER == 192'027'508)
 BENCHMARK_TEMPLATE(BM_Encode, Encoder32768);
 BENCHMARK_TEMPLATE(BM_Decode, Encoder32768);
+BENCHMARK_TEMPLATE(BM_EncodeAndDecodeSave, Encoder32768)
+    ->Arg(256 << 20)
+    ->Unit(benchmark::kMillisecond);
 #endif
 
 }  // namespace base
@@ -5,6 +5,8 @@
 #include <limits>
 #include <list>
 #include <memory>
+#include <optional>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -12,6 +14,7 @@
 #include "astronomy/stabilize_ksp.hpp"
 #include "base/not_null.hpp"
 #include "base/thread_pool.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "benchmark/benchmark.h"
 #include "geometry/frame.hpp"
 #include "geometry/named_quantities.hpp"
@@ -27,6 +30,7 @@
 #include "physics/discrete_trajectory.hpp"
 #include "physics/ephemeris.hpp"
 #include "physics/massless_body.hpp"
+#include "physics/point_mass_accelerations.hpp"
 #include "quantities/astronomy.hpp"
 #include "quantities/bipm.hpp"
 #include "quantities/elementary_functions.hpp"
@@ -41,6 +45,7 @@ using astronomy::ICRS;
 using base::make_not_null_unique;
 using base::not_null;
 using base::ThreadPool;
+using base::WorkStealingThreadPool;
 using geometry::Bivector;
 using geometry::DefinesFrame;
 using geometry::Displacement;
@@ -94,11 +99,13 @@ Length FittingTolerance(int const scale) {
   return 5 * std::pow(10.0, scale) * Metre;
 }
 
+constexpr Time ephemeris_step = 10 * Minute;
+
 Ephemeris<Barycentric>::FixedStepParameters EphemerisParameters() {
   return Ephemeris<Barycentric>::FixedStepParameters(
       SymmetricLinearMultistepIntegrator<QuinlanTremaine1990Order12,
                                          Position<Barycentric>>(),
-      /*step=*/10 * Minute);
+      /*step=*/ephemeris_step);
 }
 
 not_null<std::unique_ptr<SolarSystem<Barycentric>>> SolarSystemAtСпутник1Launch(
@@ -181,6 +188,97 @@ void BM_EphemerisSolarSystem(benchmark::State& state) {
   state.SetLabel(quantities::DebugString(error / AstronomicalUnit) + " ua");
 }
 
+// Reports the number of steps per second of the integration of the massive
+// bodies.  The argument is the number of threads used for the geopotentials, 0
+// meaning that they are computed on the thread calling |Prolong|.
+template<SolarSystemFactory::Accuracy accuracy>
+void BM_EphemerisProlong(benchmark::State& state) {
+  std::optional<WorkStealingThreadPool> thread_pool;
+  if (state.range(0) > 0) {
+    thread_pool.emplace(/*pool_size=*/state.range(0));
+  }
+  double steps = 0;
+  for (auto _ : state) {
+    state.PauseTiming();
+    auto const at_спутник_1_launch = SolarSystemAtСпутник1Launch(accuracy);
+    Instant const final_time = at_спутник_1_launch->epoch() + JulianYear;
+    auto const ephemeris =
+        at_спутник_1_launch->MakeEphemeris(
+            SolarSystemFactory::MakeAccuracyParameters<Barycentric>(
+                FittingTolerance(-3),
+                accuracy),
+            EphemerisParameters());
+    if (thread_pool.has_value()) {
+      ephemeris->SetThreadPool(&*thread_pool);
+    }
+    state.ResumeTiming();
+    ephemeris->Prolong(final_time);
+    steps += (final_time - at_спутник_1_launch->epoch()) / ephemeris_step;
+  }
+  state.counters["steps"] =
+      benchmark::Counter(steps, benchmark::Counter::kIsRate);
+}
+
+// The point-mass pair loop alone, for a system of |state.range(0)| bodies.
+template<bool scalar>
+void BM_PointMassAccelerations(benchmark::State& state) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> coordinate_distribution(-1e13, 1e13);
+  std::uniform_real_distribution<> μ_distribution(1e10, 1e20);
+  PointMasses point_masses;
+  point_masses.Resize(state.range(0));
+  for (int i = 0; i < point_masses.size(); ++i) {
+    point_masses.μ[i] = μ_distribution(random);
+    point_masses.x[i] = coordinate_distribution(random);
+    point_masses.y[i] = coordinate_distribution(random);
+    point_masses.z[i] = coordinate_distribution(random);
+  }
+  PointMassAccelerations accelerations;
+  for (auto _ : state) {
+    if constexpr (scalar) {
+      ComputePointMassAccelerationsScalar(point_masses, accelerations);
+    } else {
+      ComputePointMassAccelerations(point_masses, accelerations);
+    }
+    benchmark::DoNotOptimize(accelerations.x.data());
+  }
+}
+
+// The central term of a massive body on |state.range(0)| massless bodies.
+template<bool scalar>
+void BM_MasslessBodiesAccelerations(benchmark::State& state) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> coordinate_distribution(-1e13, 1e13);
+  MasslessBodies massless_bodies;
+  massless_bodies.Resize(state.range(0));
+  for (int i = 0; i < massless_bodies.size(); ++i) {
+    massless_bodies.x[i] = coordinate_distribution(random);
+    massless_bodies.y[i] = coordinate_distribution(random);
+    massless_bodies.z[i] = coordinate_distribution(random);
+  }
+  PointMassAccelerations accelerations;
+  accelerations.Resize(massless_bodies.size());
+  for (auto _ : state) {
+    bool no_collision;
+    if constexpr (scalar) {
+      no_collision = AccumulateMasslessBodiesAccelerationsScalar(
+          /*μ=*/1e20, /*x=*/1e12, /*y=*/2e12, /*z=*/-1e12,
+          /*collision_radius=*/1e7,
+          massless_bodies,
+          accelerations);
+    } else {
+      no_collision = AccumulateMasslessBodiesAccelerations(
+          /*μ=*/1e20, /*x=*/1e12, /*y=*/2e12, /*z=*/-1e12,
+          /*collision_radius=*/1e7,
+          massless_bodies,
+          accelerations);
+    }
+    benchmark::DoNotOptimize(no_collision);
+    benchmark::DoNotOptimize(accelerations.x.data());
+  }
+  state.SetItemsProcessed(state.iterations() * massless_bodies.size());
+}
+
 template<SolarSystemFactory::Accuracy accuracy, Flow* flow>
 void BM_EphemerisLEOProbe(benchmark::State& state) {
   Length sun_error;
@@ -598,6 +696,33 @@ BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
 BENCHMARK_TEMPLATE(BM_EphemerisSolarSystem,
                    SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness)
     ->Arg(-3);
+BENCHMARK_TEMPLATE(BM_EphemerisProlong,
+                   SolarSystemFactory::Accuracy::MajorBodiesOnly)
+    ->Arg(0);
+BENCHMARK_TEMPLATE(BM_EphemerisProlong,
+                   SolarSystemFactory::Accuracy::MinorAndMajorBodies)
+    ->Arg(0);
+BENCHMARK_TEMPLATE(BM_EphemerisProlong,
+                   SolarSystemFactory::Accuracy::AllBodiesAndDampedOblateness)
+    ->Arg(0)
+    ->Arg(2)
+    ->Arg(4);
+BENCHMARK_TEMPLATE(BM_PointMassAccelerations, /*scalar=*/true)
+    ->Arg(17)
+    ->Arg(32);
+BENCHMARK_TEMPLATE(BM_PointMassAccelerations, /*scalar=*/false)
+    ->Arg(17)
+    ->Arg(32);
+BENCHMARK_TEMPLATE(BM_MasslessBodiesAccelerations, /*scalar=*/true)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK_TEMPLATE(BM_MasslessBodiesAccelerations, /*scalar=*/false)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
 BENCHMARK_TEMPLATE(BM_EphemerisL4Probe,
                    SolarSystemFactory::Accuracy::MajorBodiesOnly,
                    &FlowEphemerisWithAdaptiveStep)
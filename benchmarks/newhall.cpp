@@ -55,6 +55,7 @@ void BM_NewhallApproximationDouble(benchmark::State& state) {
     state.ResumeTiming();
     auto const series = newhall(degree, p, v, t_min, t_max, error_estimate);
   }
+  state.SetItemsProcessed(state.iterations());
 }
 
 template<typename Result,
@@ -90,6 +91,62 @@ void BM_NewhallApproximationDisplacement(benchmark::State& state) {
     state.ResumeTiming();
     auto const series = newhall(degree, p, v, t_min, t_max, error_estimate);
   }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Searches the degree of the approximation like |ContinuousTrajectory| does
+// when it starts from scratch: the degree is increased from 3 until it reaches
+// |state.range_x()|, and an approximation is returned for that degree.  If
+// |state.range_y()| is 0, an approximation is computed for each degree; if it
+// is 1, only the error estimates are computed for each degree, and a single
+// approximation is computed at the end.
+void BM_NewhallApproximationDegreeSearch(benchmark::State& state) {
+  int const final_degree = state.range_x();
+  bool const use_approximator = state.range_y();
+  std::mt19937_64 random(42);
+  std::vector<Displacement<ICRS>> p;
+  std::vector<Variation<Displacement<ICRS>>> v;
+  Instant const t0;
+  Instant const t_min = t0 + static_cast<double>(random()) * Second;
+  Instant const t_max = t_min + static_cast<double>(random()) * Second;
+
+  Displacement<ICRS> error_estimate;
+  while (state.KeepRunning()) {
+    state.PauseTiming();
+    p.clear();
+    v.clear();
+    for (int i = 0; i <= 8; ++i) {
+      p.push_back(Displacement<ICRS>({static_cast<double>(random()) * Metre,
+                                      static_cast<double>(random()) * Metre,
+                                      static_cast<double>(random()) * Metre}));
+      v.push_back(Variation<Displacement<ICRS>>(
+          {static_cast<double>(random()) * Metre / Second,
+           static_cast<double>(random()) * Metre / Second,
+           static_cast<double>(random()) * Metre / Second}));
+    }
+    state.ResumeTiming();
+    if (use_approximator) {
+      NewhallApproximator<Displacement<ICRS>> const approximator(
+          p, v, t_min, t_max);
+      for (int degree = 3; degree <= final_degree; ++degree) {
+        error_estimate = approximator.ErrorEstimate(degree);
+      }
+      auto const polynomial =
+          approximator.ApproximationInMonomialBasis<EstrinEvaluator>(
+              final_degree);
+      benchmark::DoNotOptimize(polynomial);
+    } else {
+      for (int degree = 3; degree <= final_degree; ++degree) {
+        auto const polynomial =
+            NewhallApproximationInMonomialBasis<Displacement<ICRS>,
+                                                EstrinEvaluator>(
+                degree, p, v, t_min, t_max, error_estimate);
+        benchmark::DoNotOptimize(polynomial);
+      }
+    }
+    benchmark::DoNotOptimize(error_estimate);
+  }
+  state.SetItemsProcessed(state.iterations());
 }
 
 using ResultЧебышёвDouble = ЧебышёвSeries<double>;
@@ -120,6 +177,10 @@ BENCHMARK_TEMPLATE(
     (&NewhallApproximationInMonomialBasis<Displacement<ICRS>,
                                           EstrinEvaluator>))
     ->Arg(4)->Arg(8)->Arg(16);
+BENCHMARK(BM_NewhallApproximationDegreeSearch)
+    ->Args({3, 0})->Args({3, 1})
+    ->Args({8, 0})->Args({8, 1})
+    ->Args({16, 0})->Args({16, 1});
 
 }  // namespace numerics
 }  // namespace principia
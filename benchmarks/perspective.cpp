@@ -134,7 +134,10 @@ void BM_VisibleSegmentsOrbit(benchmark::State& state) {
                                 static_cast<double>(visible_segments_count)));
 }
 
-void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
+// If |use_cone_hierarchy| is true, the spheres are organized in a cone hierarchy
+// and only those that may hide a segment are tested.
+void OrbitMultipleSpheresBenchmark(bool const use_cone_hierarchy,
+                                   benchmark::State& state) {
   // The camera is slightly above the x-y plane and looks towards the positive
   // x-axis.
   Position<World> const camera_origin(
@@ -181,12 +184,16 @@ void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
                                  0 * Metre})));
   }
 
+  auto const cone_hierarchy = perspective.ComputeConeHierarchy(spheres);
+
   int visible_segments_count = 0;
   int visible_segments_size = 0;
   while (state.KeepRunning()) {
     for (auto const& segment : segments) {
       auto const visible_segments =
-          perspective.VisibleSegments(segment, spheres);
+          use_cone_hierarchy
+              ? perspective.VisibleSegments(segment, cone_hierarchy)
+              : perspective.VisibleSegments(segment, spheres);
       ++visible_segments_count;
       visible_segments_size += visible_segments.size();
     }
@@ -197,6 +204,14 @@ void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
                                 static_cast<double>(visible_segments_count)));
 }
 
+void BM_VisibleSegmentsOrbitMultipleSpheres(benchmark::State& state) {
+  OrbitMultipleSpheresBenchmark(/*use_cone_hierarchy=*/false, state);
+}
+
+void BM_VisibleSegmentsOrbitConeHierarchy(benchmark::State& state) {
+  OrbitMultipleSpheresBenchmark(/*use_cone_hierarchy=*/true, state);
+}
+
 void BM_VisibleSegmentsRandomEverywhere(benchmark::State& state) {
   // Generate random segments in the cube [-10, 10[³.
   std::uniform_real_distribution<> distribution(-10.0, 10.0);
@@ -217,7 +232,12 @@ void BM_VisibleSegmentsRandomNoIntersection(benchmark::State& state) {
 BENCHMARK(BM_VisibleSegmentsOrbit)->Arg(10)->Arg(100)->Arg(1000);
 BENCHMARK(BM_VisibleSegmentsRandomEverywhere)->Arg(1000);
 BENCHMARK(BM_VisibleSegmentsRandomNoIntersection)->Arg(1000);
-BENCHMARK(BM_VisibleSegmentsOrbitMultipleSpheres)->Args({1000, 20});
+BENCHMARK(BM_VisibleSegmentsOrbitMultipleSpheres)
+    ->Args({1000, 20})
+    ->Args({1000, 100});
+BENCHMARK(BM_VisibleSegmentsOrbitConeHierarchy)
+    ->Args({1000, 20})
+    ->Args({1000, 100});
 
 }  // namespace geometry
 }  // namespace principia
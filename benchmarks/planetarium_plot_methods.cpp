@@ -196,8 +196,15 @@ class Satellites {
 
 }  // namespace
 
+using PlotMethod = RP2Lines<Length, Camera> (Planetarium::*)(
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Instant const& now,
+    bool reverse) const;
+
 void RunBenchmark(benchmark::State& state,
-                  Perspective<Navigation, Camera> const& perspective) {
+                  Perspective<Navigation, Camera> const& perspective,
+                  PlotMethod const plot_method = &Planetarium::PlotMethod2) {
   Satellites satellites;
   Planetarium planetarium = satellites.MakePlanetarium(perspective);
   RP2Lines<Length, Camera> lines;
@@ -206,10 +213,10 @@ void RunBenchmark(benchmark::State& state,
   // This is the time of a lunar eclipse in January 2000.
   constexpr Instant now = "2000-01-21T04:41:30,5"_TT;
   while (state.KeepRunning()) {
-    lines = planetarium.PlotMethod2(satellites.goes_8_trajectory().begin(),
-                                    satellites.goes_8_trajectory().end(),
-                                    now,
-                                    /*reverse=*/false);
+    lines = (planetarium.*plot_method)(satellites.goes_8_trajectory().begin(),
+                                       satellites.goes_8_trajectory().end(),
+                                       now,
+                                       /*reverse=*/false);
     total_lines += lines.size();
     ++iterations;
   }
@@ -251,10 +258,22 @@ void BM_PlanetariumPlotMethod2FarEquatorialPerspective(
   RunBenchmark(state, EquatorialPerspective(far));
 }
 
+void BM_PlanetariumPlotMethod1NearEquatorialPerspective(
+    benchmark::State& state) {
+  RunBenchmark(state, EquatorialPerspective(near), &Planetarium::PlotMethod1);
+}
+
+void BM_PlanetariumPlotMethod1FarEquatorialPerspective(
+    benchmark::State& state) {
+  RunBenchmark(state, EquatorialPerspective(far), &Planetarium::PlotMethod1);
+}
+
 BENCHMARK(BM_PlanetariumPlotMethod2NearPolarPerspective);
 BENCHMARK(BM_PlanetariumPlotMethod2FarPolarPerspective);
 BENCHMARK(BM_PlanetariumPlotMethod2NearEquatorialPerspective);
 BENCHMARK(BM_PlanetariumPlotMethod2FarEquatorialPerspective);
+BENCHMARK(BM_PlanetariumPlotMethod1NearEquatorialPerspective);
+BENCHMARK(BM_PlanetariumPlotMethod1FarEquatorialPerspective);
 
 }  // namespace geometry
 }  // namespace principia
@@ -17,6 +17,7 @@
 #include "integrators/methods.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
+#include "numerics/double_precision.hpp"
 #include "glog/logging.h"
 #include "quantities/elementary_functions.hpp"
 #include "quantities/named_quantities.hpp"
@@ -34,6 +35,7 @@ using geometry::Instant;
 using geometry::Position;
 using geometry::Vector;
 using geometry::Velocity;
+using numerics::DoublePrecision;
 using quantities::Abs;
 using quantities::Acceleration;
 using quantities::AngularFrequency;
@@ -169,6 +171,51 @@ void SolveHarmonicOscillatorAndComputeError3D(benchmark::State& state,
   state.ResumeTiming();
 }
 
+// Integrates |state.range_x()| independent harmonic oscillators, so that the
+// cost of the integrator itself, as opposed to that of the right-hand side and
+// of the client, dominates.
+template<typename Integrator>
+void SolveHarmonicOscillators3D(benchmark::State& state,
+                                Integrator const& integrator) {
+  using ODE = SpecialSecondOrderDifferentialEquation<Position<World>>;
+  state.PauseTiming();
+  int const dimension = state.range_x();
+  Instant const t_initial;
+  Instant const t_final = t_initial + 10 * Second;
+  Time const step = 3.0e-4 * Second;
+
+  ODE harmonic_oscillators;
+  harmonic_oscillators.compute_acceleration =
+      [](Instant const& t,
+         std::vector<Position<World>> const& q,
+         std::vector<Vector<Acceleration, World>>& result) {
+        auto const ω² = 1 / (Second * Second);
+        for (int k = 0; k < q.size(); ++k) {
+          result[k] = (World::origin - q[k]) * ω²;
+        }
+        return Status::OK;
+      };
+  IntegrationProblem<ODE> problem;
+  problem.equation = harmonic_oscillators;
+  for (int k = 0; k < dimension; ++k) {
+    problem.initial_state.positions.emplace_back(
+        World::origin +
+        Displacement<World>({(k + 1) * Metre, k * Metre, -k * Metre}));
+    problem.initial_state.velocities.emplace_back(Velocity<World>());
+  }
+  problem.initial_state.time = DoublePrecision<Instant>(t_initial);
+  ODE::SystemState final_state;
+  auto const append_state = [&final_state](ODE::SystemState const& state) {
+    final_state = state;
+  };
+  auto const instance = integrator.NewInstance(problem, append_state, step);
+  state.ResumeTiming();
+  instance->Solve(t_final);
+  state.PauseTiming();
+  benchmark::DoNotOptimize(final_state);
+  state.ResumeTiming();
+}
+
 template<typename Method, typename Position>
 void BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D(
     benchmark::State& state) {
@@ -203,6 +250,16 @@ void BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D(
   state.SetLabel(ss.str());
 }
 
+template<typename Method>
+void BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillators3D(
+    benchmark::State& state) {
+  while (state.KeepRunning()) {
+    SolveHarmonicOscillators3D(
+        state,
+        SymplecticRungeKuttaNyströmIntegrator<Method, Position<World>>());
+  }
+}
+
 BENCHMARK_TEMPLATE2(
     BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillator1D,
     methods::McLachlanAtela1992Order4Optimal, Length);
@@ -253,5 +310,10 @@ BENCHMARK_TEMPLATE2(
     BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillator3D,
     methods::BlanesMoan2002SRKN14A, Position<World>);
 
+BENCHMARK_TEMPLATE(
+    BM_SymplecticRungeKuttaNyströmIntegratorSolveHarmonicOscillators3D,
+    methods::BlanesMoan2002SRKN14A)
+    ->Arg(1)->Arg(10)->Arg(100)->Arg(1000);
+
 }  // namespace integrators
 }  // namespace principia
@@ -7,6 +7,7 @@
 
 #include "absl/synchronization/mutex.h"
 #include "base/thread_pool.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "benchmark/benchmark.h"
 
 namespace principia {
@@ -97,6 +98,100 @@ void BM_ThreadPoolExclusiveLock(benchmark::State& state) {
   }
 }
 
+// Many short calls, where the cost of the queue dominates.
+void BM_ThreadPoolShortCalls(benchmark::State& state) {
+  ThreadPool<void> pool(/*pool_size=*/state.range_x());
+  while (state.KeepRunning()) {
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 100'000; ++i) {
+      futures.push_back(pool.Add([]() {
+        double const result = ComsumeCpuNoLock(10);
+        benchmark::DoNotOptimize(result);
+      }));
+    }
+    for (auto const& future : futures) {
+      future.wait();
+    }
+  }
+}
+
+void BM_WorkStealingThreadPoolNoLock(benchmark::State& state) {
+  WorkStealingThreadPool pool(/*pool_size=*/state.range_x());
+  while (state.KeepRunning()) {
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < 1000; ++i) {
+      tasks.push_back(pool.Add([]() {
+        double const result = ComsumeCpuNoLock(1e5);
+        benchmark::DoNotOptimize(result);
+      }));
+    }
+    for (auto const& task : tasks) {
+      task.Wait();
+    }
+  }
+}
+
+void BM_WorkStealingThreadPoolSharedLock(benchmark::State& state) {
+  WorkStealingThreadPool pool(/*pool_size=*/state.range_x());
+  while (state.KeepRunning()) {
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < 1000; ++i) {
+      tasks.push_back(pool.Add([]() {
+        double const result = ComsumeCpuSharedLock(1e5);
+        benchmark::DoNotOptimize(result);
+      }));
+    }
+    for (auto const& task : tasks) {
+      task.Wait();
+    }
+  }
+}
+
+void BM_WorkStealingThreadPoolExclusiveLock(benchmark::State& state) {
+  WorkStealingThreadPool pool(/*pool_size=*/state.range_x());
+  while (state.KeepRunning()) {
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < 1000; ++i) {
+      tasks.push_back(pool.Add([]() {
+        double const result = ComsumeCpuExclusiveLock(1e5);
+        benchmark::DoNotOptimize(result);
+      }));
+    }
+    for (auto const& task : tasks) {
+      task.Wait();
+    }
+  }
+}
+
+void BM_WorkStealingThreadPoolShortCalls(benchmark::State& state) {
+  WorkStealingThreadPool pool(/*pool_size=*/state.range_x());
+  while (state.KeepRunning()) {
+    std::vector<Task<void>> tasks;
+    for (int i = 0; i < 100'000; ++i) {
+      tasks.push_back(pool.Add([]() {
+        double const result = ComsumeCpuNoLock(10);
+        benchmark::DoNotOptimize(result);
+      }));
+    }
+    for (auto const& task : tasks) {
+      task.Wait();
+    }
+  }
+}
+
+// The same number of short calls, expressed as a nested loop.
+void BM_WorkStealingThreadPoolNestedParallelFor(benchmark::State& state) {
+  WorkStealingThreadPool pool(/*pool_size=*/state.range_x());
+  while (state.KeepRunning()) {
+    pool.ParallelFor(0, 100, [&pool](std::int64_t const i) {
+      pool.ParallelFor(0, 1000, [](std::int64_t const j) {
+        double const result = ComsumeCpuNoLock(10);
+        benchmark::DoNotOptimize(result);
+      });
+    });
+  }
+}
+
 BENCHMARK(BM_ThreadPoolNoLock)
     ->Arg(1)
     ->Arg(2)
@@ -105,7 +200,9 @@ BENCHMARK(BM_ThreadPoolNoLock)
     ->Arg(5)
     ->Arg(6)
     ->Arg(7)
-    ->Arg(8);
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(64);
 BENCHMARK(BM_ThreadPoolSharedLock)
     ->Arg(1)
     ->Arg(2)
@@ -114,7 +211,9 @@ BENCHMARK(BM_ThreadPoolSharedLock)
     ->Arg(5)
     ->Arg(6)
     ->Arg(7)
-    ->Arg(8);
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(64);
 BENCHMARK(BM_ThreadPoolExclusiveLock)
     ->Arg(1)
     ->Arg(2)
@@ -123,7 +222,31 @@ BENCHMARK(BM_ThreadPoolExclusiveLock)
     ->Arg(5)
     ->Arg(6)
     ->Arg(7)
-    ->Arg(8);
+    ->Arg(8)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK(BM_ThreadPoolShortCalls)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_WorkStealingThreadPoolNoLock)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+BENCHMARK(BM_WorkStealingThreadPoolSharedLock)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK(BM_WorkStealingThreadPoolExclusiveLock)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK(BM_WorkStealingThreadPoolShortCalls)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
+BENCHMARK(BM_WorkStealingThreadPoolNestedParallelFor)
+    ->Arg(1)
+    ->Arg(4)
+    ->Arg(16)
+    ->Arg(64);
 
 }  // namespace base
 }  // namespace principia
@@ -0,0 +1,107 @@
+﻿
+#pragma once
+
+#include <vector>
+
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "geometry/point.hpp"
+#include "geometry/sphere.hpp"
+#include "quantities/quantities.hpp"
+
+namespace principia {
+namespace geometry {
+namespace internal_cone_hierarchy {
+
+using quantities::Angle;
+
+// A bounding volume hierarchy of the cones under which some spheres are seen
+// from a point, the apex.  It is used to quickly find the spheres that may hide
+// a segment, without testing all of them: a segment is seen from the apex
+// under a cone, and only the spheres whose cones intersect it may hide part of
+// the segment.  The tests are conservative, i.e., they may return spheres that
+// don't actually intersect the cone of the segment, but never omit one that
+// does.
+template<typename Frame>
+class ConeHierarchy final {
+ public:
+  ConeHierarchy(Position<Frame> const& apex,
+                std::vector<Sphere<Frame>> spheres);
+
+  Position<Frame> const& apex() const;
+  std::vector<Sphere<Frame>> const& spheres() const;
+
+  // Fills |indices| with the indices in |spheres()|, in increasing order, of
+  // the spheres that may hide (part of) the segment from |a| to |b| as seen
+  // from the apex.
+  void FindSpheresIntersectingSegment(Position<Frame> const& a,
+                                      Position<Frame> const& b,
+                                      std::vector<int>& indices) const;
+
+ private:
+  // A cone of revolution with its apex at |apex_|.  The half angle may be up
+  // to π, in which case the cone is the entire space.
+  struct Cone {
+    Vector<double, Frame> axis;
+    Angle half_angle;
+    double cos_half_angle;
+    double sin_half_angle;
+  };
+
+  // A node of the hierarchy covers the spheres whose indices are in
+  // [begin, end[ in |order_|.  It is a leaf iff it has no children.
+  struct Node {
+    Cone cone;
+    int begin;
+    int end;
+    int left = no_child;
+    int right = no_child;
+  };
+
+  static constexpr int no_child = -1;
+
+  // The maximum number of spheres in a leaf.
+  static constexpr int max_leaf_size = 4;
+
+  // Builds the subtree for the spheres in [begin, end[ in |order_| and returns
+  // the index of its root in |nodes_|.
+  int Build(int begin, int end);
+
+  // Returns the smallest cone around the normalized sum of the axes of the
+  // spheres in [begin, end[ in |order_| that contains all their cones.
+  Cone BoundingCone(int begin, int end) const;
+
+  // Appends to |indices| the indices of the spheres of the subtree rooted at
+  // |node| whose cones may intersect the cone of the given |axis| and half
+  // angle θ.
+  void FindSpheresIntersectingCone(int node,
+                                   Vector<double, Frame> const& axis,
+                                   double cos_θ,
+                                   double sin_θ,
+                                   std::vector<int>& indices) const;
+
+  // Returns true if the |cone| may intersect the cone of the given |axis| and
+  // half angle θ.
+  static bool MayIntersect(Cone const& cone,
+                           Vector<double, Frame> const& axis,
+                           double cos_θ,
+                           double sin_θ);
+
+  static Cone MakeCone(Vector<double, Frame> const& axis,
+                       Angle const& half_angle);
+
+  Position<Frame> apex_;
+  std::vector<Sphere<Frame>> spheres_;
+  std::vector<Cone> sphere_cones_;
+  std::vector<int> order_;
+  std::vector<Node> nodes_;
+};
+
+}  // namespace internal_cone_hierarchy
+
+using internal_cone_hierarchy::ConeHierarchy;
+
+}  // namespace geometry
+}  // namespace principia
+
+#include "geometry/cone_hierarchy_body.hpp"
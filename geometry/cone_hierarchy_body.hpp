@@ -0,0 +1,210 @@
+﻿
+#pragma once
+
+#include "geometry/cone_hierarchy.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include "quantities/elementary_functions.hpp"
+#include "quantities/numbers.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace geometry {
+namespace internal_cone_hierarchy {
+
+using quantities::ArcSin;
+using quantities::Cos;
+using quantities::Length;
+using quantities::Sin;
+using quantities::si::Radian;
+
+// The cones of the spheres are enlarged by this angle to make the tests
+// conservative in the presence of rounding errors.
+constexpr Angle angular_margin = 1e-6 * Radian;
+
+template<typename Frame>
+ConeHierarchy<Frame>::ConeHierarchy(Position<Frame> const& apex,
+                                    std::vector<Sphere<Frame>> spheres)
+    : apex_(apex),
+      spheres_(std::move(spheres)) {
+  sphere_cones_.reserve(spheres_.size());
+  for (auto const& sphere : spheres_) {
+    Displacement<Frame> const apex_to_centre = sphere.centre() - apex_;
+    Length const distance = apex_to_centre.Norm();
+    // If the apex is within the sphere, the cone is the entire space.
+    Angle const half_angle =
+        distance <= sphere.radius()
+            ? π * Radian
+            : std::min(ArcSin(sphere.radius() / distance) + angular_margin,
+                       π * Radian);
+    sphere_cones_.push_back(
+        MakeCone(NormalizeOrZero(apex_to_centre), half_angle));
+  }
+  order_.resize(spheres_.size());
+  std::iota(order_.begin(), order_.end(), 0);
+  if (!spheres_.empty()) {
+    nodes_.reserve(2 * spheres_.size());
+    Build(/*begin=*/0, /*end=*/spheres_.size());
+  }
+}
+
+template<typename Frame>
+Position<Frame> const& ConeHierarchy<Frame>::apex() const {
+  return apex_;
+}
+
+template<typename Frame>
+std::vector<Sphere<Frame>> const& ConeHierarchy<Frame>::spheres() const {
+  return spheres_;
+}
+
+template<typename Frame>
+void ConeHierarchy<Frame>::FindSpheresIntersectingSegment(
+    Position<Frame> const& a,
+    Position<Frame> const& b,
+    std::vector<int>& indices) const {
+  indices.clear();
+  if (nodes_.empty()) {
+    return;
+  }
+
+  // The cone of the segment has for axis the bisector of the directions of its
+  // extremities.  If it is degenerate, we give up and return all the spheres.
+  auto const a_direction = NormalizeOrZero(a - apex_);
+  auto const b_direction = NormalizeOrZero(b - apex_);
+  auto const bisector = NormalizeOrZero(a_direction + b_direction);
+  if (a_direction == Vector<double, Frame>() ||
+      b_direction == Vector<double, Frame>() ||
+      bisector == Vector<double, Frame>()) {
+    indices = order_;
+    std::sort(indices.begin(), indices.end());
+    return;
+  }
+  double const cos_θ = InnerProduct(bisector, a_direction);
+  double const sin_θ = Wedge(bisector, a_direction).Norm();
+
+  FindSpheresIntersectingCone(/*node=*/0, bisector, cos_θ, sin_θ, indices);
+  std::sort(indices.begin(), indices.end());
+}
+
+template<typename Frame>
+int ConeHierarchy<Frame>::Build(int const begin, int const end) {
+  int const index = nodes_.size();
+  nodes_.push_back(Node{BoundingCone(begin, end), begin, end});
+  if (end - begin <= max_leaf_size) {
+    return index;
+  }
+
+  // Split the spheres at the median along the coordinate where their axes are
+  // most spread out.
+  int coordinate = 0;
+  double max_spread = -1;
+  for (int c = 0; c < 3; ++c) {
+    auto const [min, max] = std::minmax_element(
+        order_.begin() + begin,
+        order_.begin() + end,
+        [this, c](int const left, int const right) {
+          return sphere_cones_[left].axis.coordinates()[c] <
+                 sphere_cones_[right].axis.coordinates()[c];
+        });
+    double const spread = sphere_cones_[*max].axis.coordinates()[c] -
+                          sphere_cones_[*min].axis.coordinates()[c];
+    if (spread > max_spread) {
+      max_spread = spread;
+      coordinate = c;
+    }
+  }
+  int const middle = begin + (end - begin) / 2;
+  std::nth_element(
+      order_.begin() + begin,
+      order_.begin() + middle,
+      order_.begin() + end,
+      [this, coordinate](int const left, int const right) {
+        return sphere_cones_[left].axis.coordinates()[coordinate] <
+               sphere_cones_[right].axis.coordinates()[coordinate];
+      });
+
+  // Note that |Build| may reallocate |nodes_|.
+  int const left = Build(begin, middle);
+  int const right = Build(middle, end);
+  nodes_[index].left = left;
+  nodes_[index].right = right;
+  return index;
+}
+
+template<typename Frame>
+typename ConeHierarchy<Frame>::Cone ConeHierarchy<Frame>::BoundingCone(
+    int const begin,
+    int const end) const {
+  Vector<double, Frame> sum;
+  for (int i = begin; i < end; ++i) {
+    sum += sphere_cones_[order_[i]].axis;
+  }
+  auto const axis = NormalizeOrZero(sum);
+  if (axis == Vector<double, Frame>()) {
+    return MakeCone(sphere_cones_[order_[begin]].axis, π * Radian);
+  }
+  Angle half_angle;
+  for (int i = begin; i < end; ++i) {
+    Cone const& cone = sphere_cones_[order_[i]];
+    half_angle = std::max(half_angle,
+                          AngleBetween(axis, cone.axis) + cone.half_angle);
+  }
+  return MakeCone(axis, std::min(half_angle, π * Radian));
+}
+
+template<typename Frame>
+void ConeHierarchy<Frame>::FindSpheresIntersectingCone(
+    int const node,
+    Vector<double, Frame> const& axis,
+    double const cos_θ,
+    double const sin_θ,
+    std::vector<int>& indices) const {
+  Node const& n = nodes_[node];
+  if (!MayIntersect(n.cone, axis, cos_θ, sin_θ)) {
+    return;
+  }
+  if (n.left == no_child) {
+    for (int i = n.begin; i < n.end; ++i) {
+      int const sphere_index = order_[i];
+      if (MayIntersect(sphere_cones_[sphere_index], axis, cos_θ, sin_θ)) {
+        indices.push_back(sphere_index);
+      }
+    }
+  } else {
+    FindSpheresIntersectingCone(n.left, axis, cos_θ, sin_θ, indices);
+    FindSpheresIntersectingCone(n.right, axis, cos_θ, sin_θ, indices);
+  }
+}
+
+template<typename Frame>
+bool ConeHierarchy<Frame>::MayIntersect(Cone const& cone,
+                                        Vector<double, Frame> const& axis,
+                                        double const cos_θ,
+                                        double const sin_θ) {
+  // The cones intersect iff the angle between their axes is at most ɑ + θ,
+  // where ɑ is the half angle of |cone|.  θ is at most π / 2, so ɑ + θ ≥ π iff
+  // cos ɑ ≤ -cos θ, in which case the cones always intersect.  Otherwise we
+  // compare the cosines, since the cosine is decreasing on [0, π].
+  if (cone.cos_half_angle <= -cos_θ) {
+    return true;
+  }
+  double const cos_ɑ_plus_θ =
+      cone.cos_half_angle * cos_θ - cone.sin_half_angle * sin_θ;
+  return InnerProduct(cone.axis, axis) >= cos_ɑ_plus_θ;
+}
+
+template<typename Frame>
+typename ConeHierarchy<Frame>::Cone ConeHierarchy<Frame>::MakeCone(
+    Vector<double, Frame> const& axis,
+    Angle const& half_angle) {
+  return Cone{axis, half_angle, Cos(half_angle), Sin(half_angle)};
+}
+
+}  // namespace internal_cone_hierarchy
+}  // namespace geometry
+}  // namespace principia
@@ -0,0 +1,142 @@
+﻿
+#include "geometry/cone_hierarchy.hpp"
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+#include "geometry/frame.hpp"
+#include "geometry/grassmann.hpp"
+#include "geometry/named_quantities.hpp"
+#include "geometry/sphere.hpp"
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "quantities/elementary_functions.hpp"
+#include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
+
+namespace principia {
+namespace geometry {
+namespace internal_cone_hierarchy {
+
+using quantities::ArcSin;
+using quantities::si::Metre;
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+class ConeHierarchyTest : public ::testing::Test {
+ protected:
+  using World = Frame<serialization::Frame::TestTag,
+                      Inertial,
+                      Handedness::Right,
+                      serialization::Frame::TEST>;
+
+  Position<World> const apex_ = World::origin;
+};
+
+TEST_F(ConeHierarchyTest, Empty) {
+  ConeHierarchy<World> const hierarchy(apex_, {});
+  std::vector<int> indices = {1, 2, 3};
+  hierarchy.FindSpheresIntersectingSegment(
+      World::origin + Displacement<World>({1 * Metre, 0 * Metre, 0 * Metre}),
+      World::origin + Displacement<World>({0 * Metre, 1 * Metre, 0 * Metre}),
+      indices);
+  EXPECT_THAT(indices, IsEmpty());
+}
+
+TEST_F(ConeHierarchyTest, SmallHierarchy) {
+  // Spheres of radius 1 at a distance of 10 along the three axes, seen under
+  // a half angle of about 5.7°.
+  std::vector<Sphere<World>> const spheres = {
+      Sphere<World>(World::origin + Displacement<World>(
+                                        {10 * Metre, 0 * Metre, 0 * Metre}),
+                    1 * Metre),
+      Sphere<World>(World::origin + Displacement<World>(
+                                        {0 * Metre, 10 * Metre, 0 * Metre}),
+                    1 * Metre),
+      Sphere<World>(World::origin + Displacement<World>(
+                                        {0 * Metre, 0 * Metre, 10 * Metre}),
+                    1 * Metre)};
+  ConeHierarchy<World> const hierarchy(apex_, spheres);
+  std::vector<int> indices;
+
+  // A segment far from all the spheres.
+  hierarchy.FindSpheresIntersectingSegment(
+      World::origin + Displacement<World>({-5 * Metre, -5 * Metre, 0 * Metre}),
+      World::origin + Displacement<World>({-5 * Metre, -4 * Metre, 0 * Metre}),
+      indices);
+  EXPECT_THAT(indices, IsEmpty());
+
+  // A segment passing behind the first sphere.
+  hierarchy.FindSpheresIntersectingSegment(
+      World::origin + Displacement<World>({20 * Metre, -1 * Metre, 0 * Metre}),
+      World::origin + Displacement<World>({20 * Metre, 1 * Metre, 0 * Metre}),
+      indices);
+  EXPECT_THAT(indices, ElementsAre(0));
+
+  // A segment whose cone intersects the cones of the second and third spheres.
+  hierarchy.FindSpheresIntersectingSegment(
+      World::origin + Displacement<World>({0 * Metre, 10 * Metre, 0 * Metre}),
+      World::origin + Displacement<World>({0 * Metre, 0 * Metre, 10 * Metre}),
+      indices);
+  EXPECT_THAT(indices, ElementsAre(1, 2));
+
+  // A segment going through the apex.
+  hierarchy.FindSpheresIntersectingSegment(
+      World::origin + Displacement<World>({-1 * Metre, 0 * Metre, 0 * Metre}),
+      World::origin + Displacement<World>({1 * Metre, 0 * Metre, 0 * Metre}),
+      indices);
+  EXPECT_THAT(indices, ElementsAre(0, 1, 2));
+}
+
+// The hierarchy never omits a sphere whose cone intersects that of a segment,
+// and the indices are returned in increasing order.
+TEST_F(ConeHierarchyTest, Conservative) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-100.0, 100.0);
+  std::uniform_real_distribution<> radius_distribution(0.1, 10.0);
+  auto const random_position = [&distribution, &random]() {
+    return World::origin + Displacement<World>({distribution(random) * Metre,
+                                                distribution(random) * Metre,
+                                                distribution(random) * Metre});
+  };
+
+  std::vector<Sphere<World>> spheres;
+  for (int i = 0; i < 50; ++i) {
+    spheres.emplace_back(random_position(),
+                         radius_distribution(random) * Metre);
+  }
+  ConeHierarchy<World> const hierarchy(apex_, spheres);
+
+  std::vector<int> indices;
+  int total_intersecting = 0;
+  for (int i = 0; i < 1000; ++i) {
+    Position<World> const a = random_position();
+    Position<World> const b = random_position();
+    hierarchy.FindSpheresIntersectingSegment(a, b, indices);
+    EXPECT_TRUE(std::is_sorted(indices.begin(), indices.end()));
+
+    // The brute force computation.  The cone of the segment has for axis the
+    // bisector of the directions of its extremities.
+    auto const a_direction = Normalize(a - apex_);
+    auto const b_direction = Normalize(b - apex_);
+    auto const bisector = Normalize(a_direction + b_direction);
+    auto const θ = AngleBetween(bisector, a_direction);
+    for (int j = 0; j < spheres.size(); ++j) {
+      auto const& sphere = spheres[j];
+      Displacement<World> const apex_to_centre = sphere.centre() - apex_;
+      auto const ɑ = ArcSin(sphere.radius() / apex_to_centre.Norm());
+      if (AngleBetween(bisector, apex_to_centre) <= ɑ + θ) {
+        ++total_intersecting;
+        EXPECT_TRUE(std::binary_search(indices.begin(), indices.end(), j))
+            << i << " " << j;
+      }
+    }
+  }
+  // Check that the test is not vacuous.
+  EXPECT_LT(1000, total_intersecting);
+}
+
+}  // namespace internal_cone_hierarchy
+}  // namespace geometry
+}  // namespace principia
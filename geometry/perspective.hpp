@@ -7,6 +7,7 @@
 
 #include "base/array.hpp"
 #include "geometry/affine_map.hpp"
+#include "geometry/cone_hierarchy.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/point.hpp"
@@ -78,7 +79,27 @@ class Perspective final {
       Segment<FromFrame> const& segment,
       std::vector<Sphere<FromFrame>> const& spheres) const;
 
+  // Returns a hierarchy of the cones under which the |spheres| are seen from
+  // the camera, to be used by the following function.
+  ConeHierarchy<FromFrame> ComputeConeHierarchy(
+      std::vector<Sphere<FromFrame>> spheres) const;
+
+  // Same as above, but for hiding with the spheres of |hierarchy|, which must
+  // have been computed by this perspective.  Only the spheres whose cones
+  // intersect the cone of the |segment| are tested, so this is much faster
+  // than the previous function when there are many spheres.
+  Segments<FromFrame> VisibleSegments(
+      Segment<FromFrame> const& segment,
+      ConeHierarchy<FromFrame> const& hierarchy) const;
+
  private:
+  // The implementation of |VisibleSegments| for multiple spheres: |sphere(i)|
+  // returns the i-th sphere, for i in [0, size[.
+  template<typename GetSphere>
+  Segments<FromFrame> VisibleSegments(Segment<FromFrame> const& segment,
+                                      int size,
+                                      GetSphere const& sphere) const;
+
   RigidTransformation<ToFrame, FromFrame> const from_camera_;
   RigidTransformation<FromFrame, ToFrame> const to_camera_;
   Position<FromFrame> const camera_;
@@ -359,6 +359,51 @@ template<typename FromFrame, typename ToFrame>
 Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
     Segment<FromFrame> const& segment,
     std::vector<Sphere<FromFrame>> const& spheres) const {
+  return VisibleSegments(
+      segment,
+      spheres.size(),
+      [&spheres](int const i) -> Sphere<FromFrame> const& {
+        return spheres[i];
+      });
+}
+
+template<typename FromFrame, typename ToFrame>
+ConeHierarchy<FromFrame> Perspective<FromFrame, ToFrame>::ComputeConeHierarchy(
+    std::vector<Sphere<FromFrame>> spheres) const {
+  return ConeHierarchy<FromFrame>(camera_, std::move(spheres));
+}
+
+template<typename FromFrame, typename ToFrame>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    ConeHierarchy<FromFrame> const& hierarchy) const {
+  DCHECK_EQ(camera_, hierarchy.apex());
+  // A sphere whose cone doesn't intersect that of |segment| doesn't hide it,
+  // nor any part of it.  The remaining spheres are processed in their original
+  // order, so the result is the same as if all the spheres had been tested
+  // (barring degenerate cases where rounding errors would cause a sphere to
+  // hide a segment that it doesn't even come close to).
+  thread_local std::vector<int> indices;
+  hierarchy.FindSpheresIntersectingSegment(
+      segment.first, segment.second, indices);
+  if (indices.empty()) {
+    return {segment};
+  }
+  auto const& spheres = hierarchy.spheres();
+  return VisibleSegments(
+      segment,
+      indices.size(),
+      [&spheres](int const i) -> Sphere<FromFrame> const& {
+        return spheres[indices[i]];
+      });
+}
+
+template<typename FromFrame, typename ToFrame>
+template<typename GetSphere>
+Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
+    Segment<FromFrame> const& segment,
+    int const size,
+    GetSphere const& sphere) const {
   // This algorithm takes the input segment, applies the hiding by the first
   // sphere (which can result in 0, 1, or 2 segments), applies the hiding by the
   // second sphere to the resulting segments, and so on.  To reduce memory
@@ -366,7 +411,7 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   // reserve the maximum possible size.  As hiding proceeds, segments are taken
   // from the vector and replaced or appended as needed.
   Segments<FromFrame> segments;
-  segments.reserve(spheres.size() + 1);
+  segments.reserve(size + 1);
   segments.push_back(segment);
 
   // The range [in_begin, in_end[ contains the segments that have been produced
@@ -389,10 +434,11 @@ Segments<FromFrame> Perspective<FromFrame, ToFrame>::VisibleSegments(
   // are stored in a contiguous slice of the vector segments.  That slice
   // doesn't start at 0 iff at least one call to VisibleSegments returned 0
   // segments.
-  for (auto const& sphere : spheres) {
+  for (int j = 0; j < size; ++j) {
     for (int i = in_end - 1; i >= in_begin; --i) {
       auto const& old_segment = segments[i];
-      auto const new_segments_for_sphere = VisibleSegments(old_segment, sphere);
+      auto const new_segments_for_sphere =
+          VisibleSegments(old_segment, sphere(j));
       int const new_segments_for_sphere_size = new_segments_for_sphere.size();
       if (new_segments_for_sphere_size >= 1) {
         segments[--out_begin] = std::move(new_segments_for_sphere.front());
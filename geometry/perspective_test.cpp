@@ -1,5 +1,7 @@
 ﻿
 #include <limits>
+#include <random>
+#include <vector>
 
 #include "geometry/affine_map.hpp"
 #include "geometry/frame.hpp"
@@ -618,6 +620,44 @@ TEST_F(VisibleSegmentsTest, MultipleSpheres) {
               SizeIs(3));
 }
 
+// The cone hierarchy gives the same results as testing all the spheres.
+TEST_F(VisibleSegmentsTest, ConeHierarchy) {
+  std::mt19937_64 random(42);
+  std::uniform_real_distribution<> distribution(-10.0, 10.0);
+  std::uniform_real_distribution<> radius_distribution(0.1, 1.0);
+  auto const random_position = [&distribution, &random]() {
+    return World::origin + Displacement<World>({distribution(random) * Metre,
+                                                distribution(random) * Metre,
+                                                distribution(random) * Metre});
+  };
+
+  std::vector<Sphere<World>> spheres;
+  for (int i = 0; i < 30; ++i) {
+    spheres.emplace_back(random_position(),
+                         radius_distribution(random) * Metre);
+  }
+  auto const hierarchy = perspective_.ComputeConeHierarchy(spheres);
+
+  int hidden = 0;
+  for (int i = 0; i < 1000; ++i) {
+    Position<World> const p1 = random_position();
+    Position<World> const p2 =
+        p1 + Displacement<World>({0.1 * distribution(random) * Metre,
+                                  0.1 * distribution(random) * Metre,
+                                  0.1 * distribution(random) * Metre});
+    Segment<World> const segment{p1, p2};
+    auto const expected_segments =
+        perspective_.VisibleSegments(segment, spheres);
+    EXPECT_EQ(expected_segments,
+              perspective_.VisibleSegments(segment, hierarchy)) << i;
+    if (expected_segments != Segments<World>{segment}) {
+      ++hidden;
+    }
+  }
+  // Check that the test is not vacuous.
+  EXPECT_LT(100, hidden);
+}
+
 }  // namespace internal_perspective
 }  // namespace geometry
 }  // namespace principia
@@ -3,6 +3,7 @@
 
 #include "integrators/symplectic_runge_kutta_nyström_integrator.hpp"
 
+#include <algorithm>
 #include <vector>
 
 #include "base/jthread.hpp"
@@ -69,6 +70,15 @@ Instance::Solve(Instant const& t_final) {
   // Current velocity.  This is a non-const reference whose purpose is to make
   // the equations more readable.
   std::vector<DoublePrecision<Velocity>>& v = current_state.velocities;
+  // Copies of |q[k].value| and |v[k].value|.  The stages only need the values,
+  // not the errors of the compensated summation, so they read them from these
+  // contiguous arrays instead of striding through |q| and |v|.
+  std::vector<Position> q_value(dimension);
+  std::vector<Velocity> v_value(dimension);
+  for (int k = 0; k < dimension; ++k) {
+    q_value[k] = q[k].value;
+    v_value[k] = v[k].value;
+  }
 
   // Current Runge-Kutta-Nyström stage.
   std::vector<Position> q_stage(dimension);
@@ -87,41 +97,48 @@ Instance::Solve(Instant const& t_final) {
   Status status;
 
   if (composition == BAB) {
-    for (int k = 0; k < dimension; ++k) {
-      q_stage[k] = q[k].value;
-    }
-    status.Update(equation.compute_acceleration(t.value, q_stage, g));
+    status.Update(equation.compute_acceleration(t.value, q_value, g));
   }
 
   while (abs_h <= Abs((t_final - t.value) - t.error)) {
     std::fill(Δq.begin(), Δq.end(), Displacement{});
     std::fill(Δv.begin(), Δv.end(), Velocity{});
 
+    // The position of each stage is computed in the same loop as the
+    // increments of the preceding stage, to save a pass over the arrays.
     if (first_stage == 1) {
+      Time const hb₀ = h * b[0];
+      Time const ha₀ = h * a[0];
       for (int k = 0; k < dimension; ++k) {
         if (composition == BAB) {
           // exp(b₀ h B)
-          Δv[k] += h * b[0] * g[k];
+          Δv[k] += hb₀ * g[k];
         }
         // exp(a₀ h A)
-        Δq[k] += h * a[0] * (v[k].value + Δv[k]);
+        Δq[k] += ha₀ * (v_value[k] + Δv[k]);
+        q_stage[k] = q_value[k] + Δq[k];
       }
+    } else {
+      std::copy(q_value.begin(), q_value.end(), q_stage.begin());
     }
 
     for (int i = first_stage; i < stages_; ++i) {
-      for (int k = 0; k < dimension; ++k) {
-        q_stage[k] = q[k].value + Δq[k];
-      }
       status.Update(equation.compute_acceleration(
           t.value + (t.error + c[i] * h), q_stage, g));
+      Time const hbᵢ = h * b[i];
+      Time const haᵢ = h * a[i];
+      bool const is_last_stage = i == stages_ - 1;
       for (int k = 0; k < dimension; ++k) {
         // exp(bᵢ h B)
-        Δv[k] += h * b[i] * g[k];
+        Δv[k] += hbᵢ * g[k];
         // NOTE(egg): in the BAB case, at the last stage, this will be an
         // exercise in adding 0.  I don't think the optimizer can know that.  Do
         // we care?
         // exp(aᵢ h A)
-        Δq[k] += h * a[i] * (v[k].value + Δv[k]);
+        Δq[k] += haᵢ * (v_value[k] + Δv[k]);
+        if (!is_last_stage) {
+          q_stage[k] = q_value[k] + Δq[k];
+        }
       }
     }
 
@@ -130,6 +147,8 @@ Instance::Solve(Instant const& t_final) {
     for (int k = 0; k < dimension; ++k) {
       q[k].Increment(Δq[k]);
       v[k].Increment(Δv[k]);
+      q_value[k] = q[k].value;
+      v_value[k] = v[k].value;
     }
     RETURN_IF_STOPPED;
     append_state(current_state);
@@ -2,6 +2,7 @@
 #include "journal/player.hpp"
 
 #include <chrono>
+#include <cstring>
 #include <filesystem>
 #include <string>
 
@@ -9,7 +10,10 @@
 #include "base/get_line.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/version.hpp"
+#include "gipfeli/gipfeli.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "journal/profiles.hpp"
+#include "journal/recorder.hpp"
 #include "glog/logging.h"
 
 namespace principia {
@@ -18,16 +22,37 @@ using base::GetLine;
 using base::Version;
 using base::HexadecimalEncoder;
 using base::UniqueArray;
+using google::protobuf::io::CodedInputStream;
 using interface::principia__ActivatePlayer;
 
 using namespace std::chrono_literals;
 
 namespace journal {
 
-Player::Player(std::filesystem::path const& path)
-    : stream_(path, std::ios::in) {
+Player::Player(std::filesystem::path const& path,
+               ReplayProfiler* const profiler)
+    : stream_(path, std::ios::in | std::ios::binary),
+      profiler_(profiler) {
   principia__ActivatePlayer();
   CHECK(!stream_.fail());
+
+  // Look for the magic string of a binary journal.  If it's not there, this is
+  // a hexadecimal journal which we reopen in text mode.
+  std::string magic(Recorder::binary_journal_magic.size(), '\0');
+  stream_.read(magic.data(), magic.size());
+  if (stream_.gcount() == magic.size() &&
+      magic == Recorder::binary_journal_magic) {
+    binary_ = true;
+    char const compressed = stream_.get();
+    CHECK(compressed == 0 || compressed == 1) << static_cast<int>(compressed);
+    if (compressed == 1) {
+      decompressor_ = google::compression::NewGipfeliCompressor();
+    }
+  } else {
+    stream_.close();
+    stream_.open(path, std::ios::in);
+    CHECK(!stream_.fail());
+  }
 }
 
 bool Player::Play(int const index) {
@@ -74,9 +99,15 @@ bool Player::Play(int const index) {
 #endif
 
   auto const before = std::chrono::system_clock::now();
+  if (profiler_ != nullptr) {
+    profiler_->BeginMethod();
+  }
 
 #include "journal/player.generated.cc"
 
+  if (profiler_ != nullptr) {
+    profiler_->EndMethod(*method_in);
+  }
   auto const after = std::chrono::system_clock::now();
   if (after - before > 100ms) {
     LOG(ERROR) << "Long method (" << (after - before) / 1ms << " ms):\n"
@@ -98,6 +129,9 @@ serialization::Method const& Player::last_method_out_return() const {
 }
 
 std::unique_ptr<serialization::Method> Player::Read() {
+  if (binary_) {
+    return ReadBinary();
+  }
   std::string const line = GetLine(stream_);
   if (line.empty()) {
     return nullptr;
@@ -111,5 +145,66 @@ std::unique_ptr<serialization::Method> Player::Read() {
   return method;
 }
 
+std::unique_ptr<serialization::Method> Player::ReadBinary() {
+  // A message may straddle blocks, so read blocks until the buffer contains
+  // the complete message.
+  do {
+    auto const* const data =
+        reinterpret_cast<std::uint8_t const*>(binary_buffer_.data()) +
+        binary_position_;
+    int const available = binary_buffer_.size() - binary_position_;
+    CodedInputStream input(data, available);
+    std::uint32_t size;
+    if (input.ReadVarint32(&size) &&
+        input.CurrentPosition() + static_cast<std::int64_t>(size) <=
+            available) {
+      auto method = std::make_unique<serialization::Method>();
+      CHECK(method->ParseFromArray(data + input.CurrentPosition(), size));
+      binary_position_ += input.CurrentPosition() + size;
+      return method;
+    }
+  } while (ReadBinaryBlock());
+  LOG_IF(ERROR, binary_position_ != binary_buffer_.size())
+      << "Truncated message at end of journal";
+  return nullptr;
+}
+
+bool Player::ReadBinaryBlock() {
+  // Discard the bytes that have already been parsed.
+  binary_buffer_.erase(0, binary_position_);
+  binary_position_ = 0;
+
+  std::uint8_t header[2 * sizeof(std::uint32_t)];
+  stream_.read(reinterpret_cast<char*>(header), sizeof(header));
+  if (stream_.gcount() == 0) {
+    return false;
+  } else if (stream_.gcount() != sizeof(header)) {
+    LOG(ERROR) << "Truncated block header at end of journal";
+    return false;
+  }
+  std::uint32_t uncompressed_size;
+  std::uint32_t stored_size;
+  CodedInputStream::ReadLittleEndian32FromArray(&header[0],
+                                                &uncompressed_size);
+  CodedInputStream::ReadLittleEndian32FromArray(&header[sizeof(std::uint32_t)],
+                                                &stored_size);
+
+  std::string stored_block(stored_size, '\0');
+  stream_.read(stored_block.data(), stored_size);
+  if (stream_.gcount() != stored_size) {
+    LOG(ERROR) << "Truncated block at end of journal";
+    return false;
+  }
+  if (decompressor_ == nullptr) {
+    binary_buffer_.append(stored_block);
+  } else {
+    std::string block;
+    CHECK(decompressor_->Uncompress(stored_block, &block));
+    CHECK_EQ(uncompressed_size, block.size());
+    binary_buffer_.append(block);
+  }
+  return true;
+}
+
 }  // namespace journal
 }  // namespace principia
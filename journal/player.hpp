@@ -5,7 +5,10 @@
 #include <fstream>
 #include <map>
 #include <memory>
+#include <string>
 
+#include "gipfeli/compression.h"
+#include "journal/replay_profiler.hpp"
 #include "serialization/journal.pb.h"
 
 #define PRINCIPIA_PLAYER_ALLOW_VERSION_MISMATCH 0
@@ -17,7 +20,11 @@ class Player final {
  public:
   using PointerMap = std::map<std::uint64_t, void*>;
 
-  explicit Player(std::filesystem::path const& path);
+  // Reads either a hexadecimal or a binary journal, see |Recorder::Format|.
+  // If |profiler| is not null, the methods replayed are timed and recorded in
+  // it; the reading and decoding of the journal are not timed.
+  explicit Player(std::filesystem::path const& path,
+                  ReplayProfiler* profiler = nullptr);
 
   // Replays the next message in the journal.  Returns false at end of journal.
   // |index| is the 0-based index of the message in the journal.
@@ -31,12 +38,27 @@ class Player final {
   // Reads one message from the stream.  Returns a |nullptr| at end of stream.
   std::unique_ptr<serialization::Method> Read();
 
+  // Same as above for a binary journal.
+  std::unique_ptr<serialization::Method> ReadBinary();
+
+  // Reads one block of a binary journal and appends it, uncompressed, to
+  // |binary_buffer_|.  Returns false at end of stream.
+  bool ReadBinaryBlock();
+
   template<typename Profile>
   bool RunIfAppropriate(serialization::Method const& method_in,
                         serialization::Method const& method_out_return);
 
   PointerMap pointer_map_;
   std::ifstream stream_;
+  ReplayProfiler* const profiler_;
+
+  // Only used for a binary journal.  The bytes of |binary_buffer_| before
+  // |binary_position_| have already been parsed.
+  bool binary_ = false;
+  std::unique_ptr<google::compression::Compressor> decompressor_;
+  std::string binary_buffer_;
+  std::size_t binary_position_ = 0;
 
   std::unique_ptr<serialization::Method> last_method_in_;
   std::unique_ptr<serialization::Method> last_method_out_return_;
@@ -1,7 +1,12 @@
 ﻿
 #include "journal/player.hpp"
 
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
 #include <list>
+#include <new>
+#include <sstream>
 #include <string>
 #include <vector>
 
@@ -11,9 +16,36 @@
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"
 #include "journal/recorder.hpp"
+#include "journal/replay_profiler.hpp"
 #include "ksp_plugin/interface.hpp"
 #include "serialization/journal.pb.h"
 
+// Set to 1 to have |DISABLED_SECULAR_Profile| report the allocations.  This
+// replaces the global allocator of the entire test binary with one that counts
+// the allocations, so it must not be checked in.
+#define PRINCIPIA_REPLAY_COUNT_ALLOCATIONS 0
+#if PRINCIPIA_REPLAY_COUNT_ALLOCATIONS
+namespace {
+std::atomic<std::int64_t> allocations = 0;
+}  // namespace
+
+void* operator new(std::size_t const size) {
+  allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* const p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* const p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* const p, std::size_t) noexcept {
+  std::free(p);
+}
+#endif
+
 namespace principia {
 namespace journal {
 
@@ -84,6 +116,32 @@ TEST_F(PlayerTest, DISABLED_SECULAR_Benchmarks) {
   benchmark::RunSpecifiedBenchmarks();
 }
 
+TEST_F(PlayerTest, DISABLED_SECULAR_Profile) {
+  google::LogToStderr();
+  // Replays a journal at full speed and reports the time per interface method
+  // and per frame, as well as the allocations if
+  // |PRINCIPIA_REPLAY_COUNT_ALLOCATIONS| is set.  You must set |path|.
+  std::string path =
+      R"(P:\Public Mockingbird\Principia\Journals\JOURNAL.20180311-192733)";
+#if PRINCIPIA_REPLAY_COUNT_ALLOCATIONS
+  ReplayProfiler profiler([]() {
+    return allocations.load(std::memory_order_relaxed);
+  });
+#else
+  ReplayProfiler profiler;
+#endif
+  Player player(path, &profiler);
+  int count = 0;
+  while (player.Play(count)) {
+    ++count;
+    LOG_IF(ERROR, (count % 100'000) == 0) << count
+                                          << " journal entries replayed";
+  }
+  std::stringstream report;
+  profiler.WriteReport(report);
+  LOG(ERROR) << count << " journal entries in total\n" << report.str();
+}
+
 TEST_F(PlayerTest, DISABLED_SECULAR_Debug) {
   google::LogToStderr();
   // An example of how journaling may be used for debugging.  You must set
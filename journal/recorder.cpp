@@ -1,26 +1,74 @@
 ﻿
 #include "journal/recorder.hpp"
 
+#include <algorithm>
+#include <cstring>
 #include <filesystem>
+#include <utility>
 
+#include "absl/time/time.h"
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/serialization.hpp"
 #include "base/version.hpp"
 #include "glog/logging.h"
+#include "google/protobuf/io/coded_stream.h"
 #include "journal/profiles.hpp"
 
 namespace principia {
 
 using base::HexadecimalEncoder;
+using base::MakeStoppableThread;
 using base::SerializeAsBytes;
 using base::UniqueArray;
 
+using google::protobuf::io::CodedOutputStream;
+
 namespace journal {
 
+namespace {
+
+// The initial size of the ring buffer of a binary journal.  It is only grown
+// for messages that don't fit in it.
+constexpr std::int64_t initial_ring_size = 16 << 20;
+// The maximum number of bytes in a block of a binary journal.
+constexpr std::int64_t max_block_size = 1 << 20;
+// The maximum time during which bytes stay in the ring buffer.
+constexpr absl::Duration max_block_delay = absl::Milliseconds(100);
+
+}  // namespace
+
 Recorder::Recorder(std::filesystem::path const& path)
-    : stream_(path, std::ios::out) {
+    : Recorder(path, Format::Hexadecimal, /*compressor=*/nullptr) {}
+
+Recorder::Recorder(std::filesystem::path const& path,
+                   Format const format,
+                   std::unique_ptr<google::compression::Compressor> compressor)
+    : format_(format),
+      compressor_(std::move(compressor)),
+      stream_(path,
+              format == Format::Binary ? std::ios::out | std::ios::binary
+                                       : std::ios::out) {
   CHECK(!stream_.fail()) << path;
+  CHECK(format_ == Format::Binary || compressor_ == nullptr)
+      << "Only binary journals may be compressed";
+  if (format_ == Format::Binary) {
+    stream_.write(binary_journal_magic.data(), binary_journal_magic.size());
+    stream_.put(compressor_ == nullptr ? 0 : 1);
+    ring_.resize(initial_ring_size);
+    writer_ = MakeStoppableThread([this]() { WriteBlocks(); });
+  }
+}
+
+Recorder::~Recorder() {
+  if (format_ == Format::Binary) {
+    {
+      absl::MutexLock l(&ring_lock_);
+      shutdown_ = true;
+    }
+    // Wait for the writer to drain the ring buffer.
+    writer_.join();
+  }
 }
 
 void Recorder::WriteAtConstruction(serialization::Method const& method) {
@@ -62,6 +110,19 @@ bool Recorder::IsActivated() {
 }
 
 void Recorder::WriteLocked(serialization::Method const& method) {
+  if (format_ == Format::Binary) {
+    std::size_t const size = method.ByteSizeLong();
+    CHECK_LT(0, size) << method.DebugString();
+    std::size_t const prefix_size =
+        CodedOutputStream::VarintSize32(static_cast<std::uint32_t>(size));
+    frame_.resize(prefix_size + size);
+    auto* const begin = reinterpret_cast<std::uint8_t*>(frame_.data());
+    CodedOutputStream::WriteVarint32ToArray(static_cast<std::uint32_t>(size),
+                                            begin);
+    method.SerializeWithCachedSizesToArray(begin + prefix_size);
+    PushFrameLocked();
+    return;
+  }
   static auto* const encoder = new HexadecimalEncoder</*null_terminated=*/true>;
   CHECK_LT(0, method.ByteSize()) << method.DebugString();
   auto const hexadecimal = encoder->Encode(SerializeAsBytes(method).get());
@@ -69,6 +130,115 @@ void Recorder::WriteLocked(serialization::Method const& method) {
   stream_.flush();
 }
 
+void Recorder::PushFrameLocked() {
+  std::int64_t const frame_size = frame_.size();
+  std::int64_t begin = ring_begin_.load(std::memory_order_acquire);
+  std::int64_t end = ring_end_.load(std::memory_order_relaxed);
+  std::int64_t ring_size = ring_.size();
+  if (end - begin + frame_size > ring_size) {
+    absl::MutexLock l(&ring_lock_);
+    if (frame_size > ring_size) {
+      // The frame doesn't fit: wait for the ring buffer to be drained and grow
+      // it.  This is rare enough that the pause doesn't matter.
+      auto const ring_is_empty = [this]() {
+        return ring_begin_.load(std::memory_order_acquire) ==
+               ring_end_.load(std::memory_order_relaxed);
+      };
+      ring_lock_.Await(absl::Condition(&ring_is_empty));
+      ring_.resize(std::max(frame_size, 2 * ring_size));
+      ring_size = ring_.size();
+      ring_begin_.store(0, std::memory_order_relaxed);
+      ring_end_.store(0, std::memory_order_relaxed);
+    }
+    auto const ring_has_room = [this, frame_size, ring_size]() {
+      return ring_end_.load(std::memory_order_relaxed) -
+                 ring_begin_.load(std::memory_order_acquire) + frame_size <=
+             ring_size;
+    };
+    ring_lock_.Await(absl::Condition(&ring_has_room));
+    begin = ring_begin_.load(std::memory_order_acquire);
+    end = ring_end_.load(std::memory_order_relaxed);
+  }
+
+  // Copy the frame, possibly wrapping around the end of the ring buffer.  The
+  // writer doesn't look at these bytes until |ring_end_| is updated.
+  std::int64_t const offset = end % ring_size;
+  std::int64_t const first_part = std::min(frame_size, ring_size - offset);
+  std::memcpy(&ring_[offset], frame_.data(), first_part);
+  std::memcpy(&ring_[0], frame_.data() + first_part, frame_size - first_part);
+  ring_end_.store(end + frame_size, std::memory_order_release);
+
+  if (end - begin < max_block_size &&
+      end + frame_size - begin >= max_block_size) {
+    // There is now enough data for a block.  The conditions are evaluated when
+    // the lock is released, so this wakes up the writer.
+    absl::MutexLock l(&ring_lock_);
+  }
+}
+
+void Recorder::WriteBlocks() {
+  std::string block;
+  std::string compressed_block;
+  for (;;) {
+    std::int64_t begin;
+    std::int64_t end;
+    std::int64_t ring_size;
+    {
+      absl::MutexLock l(&ring_lock_);
+      // Waking up for each message would be costly for the recording threads,
+      // so wait until there are enough bytes for a block, but not too long, as
+      // the messages in the ring buffer are lost if the process crashes.
+      auto const has_block_or_shutdown = [this]() {
+        return ring_end_.load(std::memory_order_relaxed) -
+                       ring_begin_.load(std::memory_order_relaxed) >=
+                   max_block_size ||
+               shutdown_;
+      };
+      ring_lock_.AwaitWithTimeout(absl::Condition(&has_block_or_shutdown),
+                                  max_block_delay);
+      begin = ring_begin_.load(std::memory_order_relaxed);
+      end = ring_end_.load(std::memory_order_acquire);
+      if (begin == end) {
+        if (shutdown_) {
+          return;
+        }
+        continue;
+      }
+      end = std::min(end, begin + max_block_size);
+      ring_size = ring_.size();
+    }
+
+    // Copy the bytes to the block and release them so that the recording
+    // threads may proceed while we compress and write.
+    std::int64_t const block_size = end - begin;
+    std::int64_t const offset = begin % ring_size;
+    std::int64_t const first_part = std::min(block_size, ring_size - offset);
+    block.resize(block_size);
+    std::memcpy(block.data(), &ring_[offset], first_part);
+    std::memcpy(block.data() + first_part, &ring_[0], block_size - first_part);
+    {
+      // Take the lock so that the recording threads waiting for room notice.
+      absl::MutexLock l(&ring_lock_);
+      ring_begin_.store(end, std::memory_order_release);
+    }
+
+    std::string const* stored_block = &block;
+    if (compressor_ != nullptr) {
+      compressor_->Compress(block, &compressed_block);
+      stored_block = &compressed_block;
+    }
+    std::uint8_t header[2 * sizeof(std::uint32_t)];
+    CodedOutputStream::WriteLittleEndian32ToArray(
+        static_cast<std::uint32_t>(block.size()), &header[0]);
+    CodedOutputStream::WriteLittleEndian32ToArray(
+        static_cast<std::uint32_t>(stored_block->size()),
+        &header[sizeof(std::uint32_t)]);
+    stream_.write(reinterpret_cast<char const*>(header), sizeof(header));
+    stream_.write(stored_block->data(), stored_block->size());
+    stream_.flush();
+  }
+}
+
 Recorder* Recorder::active_recorder_ = nullptr;
 
 }  // namespace journal
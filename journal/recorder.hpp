@@ -1,11 +1,19 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
+#include "base/jthread.hpp"
 #include "base/not_null.hpp"
+#include "gipfeli/compression.h"
 #include "serialization/journal.pb.h"
 
 namespace principia {
@@ -15,8 +23,37 @@ FORWARD_DECLARE_FROM(method, template<typename Profile> class, Method);
 
 class Recorder final {
  public:
+  enum class Format {
+    // One message per line, encoded in hexadecimal.  Each message is written
+    // and flushed by the thread that records it, so the journal is complete
+    // even if the process crashes.
+    Hexadecimal,
+    // A header followed by binary messages prefixed by their varint-encoded
+    // size.  The messages are copied to a ring buffer which is drained by a
+    // background thread, so recording is much cheaper for the caller, but the
+    // last messages may be lost if the process terminates abnormally.  The
+    // bytes are written in blocks, which may be compressed.
+    Binary,
+  };
+
+  // The first bytes of a binary journal.  They are followed by one byte which
+  // is 1 if the blocks are compressed with gipfeli and 0 otherwise.  Each block
+  // has a header made of its uncompressed and stored sizes, as little-endian
+  // 32-bit integers.
+  static constexpr std::string_view binary_journal_magic = "PRINCIPIA_JOURNAL";
+
+  // Records a hexadecimal journal.
   explicit Recorder(std::filesystem::path const& path);
 
+  // Records a journal in the given |format|.  If |compressor| is not null,
+  // |format| must be binary and the blocks are compressed.
+  Recorder(std::filesystem::path const& path,
+           Format format,
+           std::unique_ptr<google::compression::Compressor> compressor);
+
+  // Waits until all the recorded messages have been written.
+  ~Recorder();
+
   // Locking is used to ensure that the pairs of writes don't get intermixed.
   void WriteAtConstruction(serialization::Method const& method);
   void WriteAtDestruction(serialization::Method const& method);
@@ -28,8 +65,40 @@ class Recorder final {
  private:
   void WriteLocked(serialization::Method const& method);
 
+  // Copies |frame_| to the ring buffer, waiting for the background thread to
+  // make room if needed.  Must be called while holding |lock_|.
+  void PushFrameLocked();
+
+  // The loop executed by |writer_| for a binary journal.  Returns once
+  // |shutdown_| is set and the ring buffer is empty.
+  void WriteBlocks();
+
+  Format const format_;
+  std::unique_ptr<google::compression::Compressor> const compressor_;
+
+  // Held from the construction to the destruction of a |Method|.
   absl::Mutex lock_;
+  // Used by the recording threads for a hexadecimal journal, and by |writer_|
+  // for a binary journal.
   std::ofstream stream_;
+  // The serialized message being pushed to the ring buffer, prefixed by its
+  // size.  Only accessed while holding |lock_|.
+  std::string frame_;
+
+  // The ring buffer of a binary journal.  The positions are monotonic and must
+  // be reduced modulo the size of |ring_|.  The bytes between |ring_begin_| and
+  // |ring_end_| are only accessed by |writer_|, the others only by the
+  // recording threads.  |ring_begin_| is only advanced by |writer_|, and
+  // |ring_end_| by the recording threads, so that in the common case
+  // recording a message doesn't take |ring_lock_|.  The lock is only used to
+  // wait, and to reset the positions when |ring_| is resized, which only
+  // happens when it is empty.
+  absl::Mutex ring_lock_;
+  std::vector<char> ring_;
+  std::atomic<std::int64_t> ring_begin_ = 0;
+  std::atomic<std::int64_t> ring_end_ = 0;
+  bool shutdown_ GUARDED_BY(ring_lock_) = false;
+  base::jthread writer_;
 
   static Recorder* active_recorder_;
 
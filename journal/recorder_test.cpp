@@ -9,6 +9,8 @@
 #include "base/array.hpp"
 #include "base/hexadecimal.hpp"
 #include "base/version.hpp"
+#include "benchmark/benchmark.h"
+#include "gipfeli/gipfeli.h"
 #include "gtest/gtest.h"
 #include "journal/method.hpp"
 #include "journal/profiles.hpp"
@@ -19,6 +21,57 @@
 namespace principia {
 namespace journal {
 
+namespace {
+
+// Returns a method of |size| bytes (give or take a few), with contents that
+// depend on |index|.
+serialization::Method MakeMethod(int const index, int const size) {
+  serialization::Method method;
+  auto* const out =
+      method.MutableExtension(serialization::GetVersion::extension)
+          ->mutable_out();
+  out->set_build_date(std::to_string(index));
+  out->set_version(std::string(size, 'a' + index % 26));
+  return method;
+}
+
+// Measures the cost of recording an interface call, i.e., a pair of messages
+// of typical size.
+void BenchmarkRecorder(Recorder::Format const format,
+                       bool const compressed,
+                       benchmark::State& state) {
+  Recorder recorder(
+      "benchmark.journal",
+      format,
+      compressed ? google::compression::NewGipfeliCompressor() : nullptr);
+  serialization::Method const method_in = MakeMethod(0, 50);
+  serialization::Method const method_out_return = MakeMethod(1, 30);
+  for (auto _ : state) {
+    recorder.WriteAtConstruction(method_in);
+    recorder.WriteAtDestruction(method_out_return);
+  }
+}
+
+}  // namespace
+
+void BM_RecordHexadecimal(benchmark::State& state) {
+  BenchmarkRecorder(Recorder::Format::Hexadecimal,
+                    /*compressed=*/false,
+                    state);
+}
+
+void BM_RecordBinary(benchmark::State& state) {
+  BenchmarkRecorder(Recorder::Format::Binary, /*compressed=*/false, state);
+}
+
+void BM_RecordBinaryGipfeli(benchmark::State& state) {
+  BenchmarkRecorder(Recorder::Format::Binary, /*compressed=*/true, state);
+}
+
+BENCHMARK(BM_RecordHexadecimal);
+BENCHMARK(BM_RecordBinary);
+BENCHMARK(BM_RecordBinaryGipfeli);
+
 class RecorderTest : public testing::Test {
  protected:
   RecorderTest()
@@ -143,5 +196,43 @@ TEST_F(RecorderTest, Recording) {
   }
 }
 
+TEST_F(RecorderTest, Binary) {
+  for (bool const compressed : {false, true}) {
+    std::string const path =
+        test_name_ + (compressed ? ".gipfeli" : "") + ".journal.bin";
+    // Enough bytes to wrap around the ring buffer several times, with one
+    // message that doesn't fit in it.
+    std::vector<int> sizes;
+    for (int i = 0; i < 10'000; ++i) {
+      sizes.push_back(1 + (i * 7919) % 5000);
+    }
+    sizes.push_back(20 << 20);
+    for (int i = 0; i < 9'999; ++i) {
+      sizes.push_back(1 + (i * 7919) % 5000);
+    }
+    {
+      Recorder recorder(
+          path,
+          Recorder::Format::Binary,
+          compressed ? google::compression::NewGipfeliCompressor() : nullptr);
+      for (int i = 0; i < sizes.size(); i += 2) {
+        recorder.WriteAtConstruction(MakeMethod(i, sizes[i]));
+        recorder.WriteAtDestruction(MakeMethod(i + 1, sizes[i + 1]));
+      }
+    }
+
+    std::vector<serialization::Method> const methods = ReadAll(path);
+    ASSERT_EQ(sizes.size(), methods.size());
+    for (int i = 0; i < sizes.size(); ++i) {
+      EXPECT_EQ(MakeMethod(i, sizes[i]).SerializeAsString(),
+                methods[i].SerializeAsString()) << i;
+    }
+  }
+}
+
+TEST_F(RecorderTest, DISABLED_SECULAR_Benchmarks) {
+  benchmark::RunSpecifiedBenchmarks();
+}
+
 }  // namespace journal
 }  // namespace principia
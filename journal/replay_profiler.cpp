@@ -0,0 +1,188 @@
+﻿
+#include "journal/replay_profiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "glog/logging.h"
+
+namespace principia {
+namespace journal {
+
+using google::protobuf::FieldDescriptor;
+using namespace std::chrono_literals;
+
+namespace {
+
+// Returns the extension of |method_in| that identifies the interface method.
+FieldDescriptor const* MethodExtension(
+    serialization::Method const& method_in) {
+  std::vector<FieldDescriptor const*> fields;
+  method_in.GetReflection()->ListFields(method_in, &fields);
+  CHECK_EQ(1, fields.size()) << method_in.ShortDebugString();
+  return fields.front();
+}
+
+std::string MethodName(FieldDescriptor const* const extension) {
+  return "principia__" + extension->extension_scope()->name();
+}
+
+// Writes |duration| with a unit appropriate to its magnitude.
+void WriteDuration(std::ostream& out, std::chrono::nanoseconds const duration) {
+  std::ostringstream s;
+  s << std::setprecision(3) << std::fixed;
+  if (duration < 1us) {
+    s << duration.count() << " ns";
+  } else if (duration < 1ms) {
+    s << duration.count() / 1e3 << " µs";
+  } else if (duration < 1s) {
+    s << duration.count() / 1e6 << " ms";
+  } else {
+    s << duration.count() / 1e9 << " s";
+  }
+  out << s.str();
+}
+
+}  // namespace
+
+ReplayProfiler::ReplayProfiler(AllocationCounter allocation_counter)
+    : allocation_counter_(std::move(allocation_counter)) {}
+
+void ReplayProfiler::BeginMethod() {
+  if (allocation_counter_ != nullptr) {
+    method_start_allocations_ = allocation_counter_();
+  }
+  method_start_ = std::chrono::steady_clock::now();
+}
+
+void ReplayProfiler::EndMethod(serialization::Method const& method_in) {
+  auto const method_end = std::chrono::steady_clock::now();
+  std::int64_t const allocations =
+      allocation_counter_ == nullptr
+          ? 0
+          : allocation_counter_() - method_start_allocations_;
+  Record(method_in, method_end - method_start_, allocations);
+}
+
+void ReplayProfiler::Record(serialization::Method const& method_in,
+                            std::chrono::nanoseconds const duration,
+                            std::int64_t const allocations) {
+  if (method_in.HasExtension(serialization::AdvanceTime::extension)) {
+    EndFrame();
+    in_frame_ = true;
+  }
+  methods_[MethodExtension(method_in)].Add(duration, allocations);
+  if (in_frame_) {
+    frame_duration_ += duration;
+    frame_allocations_ += allocations;
+  }
+}
+
+void ReplayProfiler::WriteReport(std::ostream& out) const {
+  bool const with_allocations = allocation_counter_ != nullptr;
+
+  std::vector<std::pair<FieldDescriptor const*, Statistics const*>> methods;
+  std::chrono::nanoseconds total{0};
+  for (auto const& [extension, statistics] : methods_) {
+    methods.emplace_back(extension, &statistics);
+    total += statistics.total;
+  }
+  std::sort(methods.begin(),
+            methods.end(),
+            [](auto const& left, auto const& right) {
+              return left.second->total > right.second->total;
+            });
+
+  out << "Replayed " << methods_.size() << " distinct methods in ";
+  WriteDuration(out, total);
+  out << "\n";
+  for (auto const& [extension, statistics] : methods) {
+    out << MethodName(extension) << " ("
+        << std::setprecision(3) << std::fixed
+        << 100.0 * statistics->total.count() /
+               std::max<std::int64_t>(total.count(), 1)
+        << "% of total)\n";
+    statistics->Write(out, with_allocations);
+  }
+
+  // Include the frame being replayed, which is not terminated by a call to
+  // |principia__AdvanceTime|.
+  Statistics frames = frames_;
+  if (in_frame_) {
+    frames.Add(frame_duration_, frame_allocations_);
+  }
+  out << "Frames\n";
+  frames.Write(out, with_allocations);
+}
+
+void ReplayProfiler::Statistics::Add(std::chrono::nanoseconds const duration,
+                                     std::int64_t const allocations) {
+  ++count;
+  total += duration;
+  max = std::max(max, duration);
+  this->allocations += allocations;
+  max_allocations = std::max(max_allocations, allocations);
+  int bucket = 0;
+  if (duration.count() > 1) {
+    bucket = std::min(std::ilogb(static_cast<double>(duration.count())),
+                      histogram_buckets - 1);
+  }
+  ++histogram[bucket];
+}
+
+std::chrono::nanoseconds ReplayProfiler::Statistics::Quantile(
+    double const quantile) const {
+  auto const rank = static_cast<std::int64_t>(std::ceil(quantile * count));
+  std::int64_t cumulative = 0;
+  for (int i = 0; i < histogram_buckets; ++i) {
+    cumulative += histogram[i];
+    if (cumulative >= rank) {
+      return std::min(max, std::chrono::nanoseconds(std::int64_t{2} << i));
+    }
+  }
+  return max;
+}
+
+void ReplayProfiler::Statistics::Write(std::ostream& out,
+                                       bool const with_allocations) const {
+  out << "  count: " << count << ", total: ";
+  WriteDuration(out, total);
+  out << ", mean: ";
+  WriteDuration(out, total / std::max<std::int64_t>(count, 1));
+  out << ", p50 ≤ ";
+  WriteDuration(out, Quantile(0.5));
+  out << ", p99 ≤ ";
+  WriteDuration(out, Quantile(0.99));
+  out << ", max: ";
+  WriteDuration(out, max);
+  out << "\n";
+  if (with_allocations) {
+    out << "  allocations: " << allocations << ", mean: "
+        << std::setprecision(1) << std::fixed
+        << static_cast<double>(allocations) / std::max<std::int64_t>(count, 1)
+        << ", max: " << max_allocations << "\n";
+  }
+  for (int i = 0; i < histogram_buckets; ++i) {
+    if (histogram[i] > 0) {
+      out << "  < ";
+      WriteDuration(out, std::chrono::nanoseconds(std::int64_t{2} << i));
+      out << ": " << histogram[i] << "\n";
+    }
+  }
+}
+
+void ReplayProfiler::EndFrame() {
+  if (in_frame_) {
+    frames_.Add(frame_duration_, frame_allocations_);
+  }
+  frame_duration_ = 0ns;
+  frame_allocations_ = 0;
+}
+
+}  // namespace journal
+}  // namespace principia
@@ -0,0 +1,89 @@
+﻿
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <ostream>
+
+#include "google/protobuf/descriptor.h"
+#include "serialization/journal.pb.h"
+
+namespace principia {
+namespace journal {
+
+// Collects the wall time and the number of allocations of the methods replayed
+// by a |Player|, and reports them per interface method and per frame.  A frame
+// starts with each call to |principia__AdvanceTime|; the methods replayed
+// before the first such call are not part of any frame.
+class ReplayProfiler final {
+ public:
+  // Returns the number of allocations performed by the process so far.  The
+  // binary that replays the journal must count them itself, typically by
+  // replacing the global |operator new|.
+  using AllocationCounter = std::function<std::int64_t()>;
+
+  // If |allocation_counter| is null, the allocations are not reported.
+  explicit ReplayProfiler(AllocationCounter allocation_counter = nullptr);
+
+  // Called by the |Player| immediately before and after running a method.
+  void BeginMethod();
+  void EndMethod(serialization::Method const& method_in);
+
+  // Records that the method |method_in| took |duration| and performed
+  // |allocations| allocations.
+  void Record(serialization::Method const& method_in,
+              std::chrono::nanoseconds duration,
+              std::int64_t allocations);
+
+  // Writes the statistics per method, ordered by decreasing total time, and
+  // the statistics per frame.
+  void WriteReport(std::ostream& out) const;
+
+ private:
+  // Bucket |i| counts the durations in [2^i ns, 2^(i + 1) ns[, except that the
+  // first bucket also counts the durations below 1 ns and the last one those
+  // above 2^39 ns, about 9 min.
+  static constexpr int histogram_buckets = 40;
+
+  struct Statistics {
+    void Add(std::chrono::nanoseconds duration, std::int64_t allocations);
+
+    // Returns an upper bound for the |quantile| of the durations, computed from
+    // the histogram.
+    std::chrono::nanoseconds Quantile(double quantile) const;
+
+    void Write(std::ostream& out, bool with_allocations) const;
+
+    std::int64_t count = 0;
+    std::chrono::nanoseconds total{0};
+    std::chrono::nanoseconds max{0};
+    std::int64_t allocations = 0;
+    std::int64_t max_allocations = 0;
+    std::array<std::int64_t, histogram_buckets> histogram{};
+  };
+
+  void EndFrame();
+
+  AllocationCounter const allocation_counter_;
+
+  // The method being replayed, between |BeginMethod| and |EndMethod|.
+  std::chrono::steady_clock::time_point method_start_;
+  std::int64_t method_start_allocations_ = 0;
+
+  // Keyed by the extension of |serialization::Method| that identifies the
+  // interface method.
+  std::map<google::protobuf::FieldDescriptor const*, Statistics> methods_;
+
+  // The frame being replayed, if any.
+  bool in_frame_ = false;
+  std::chrono::nanoseconds frame_duration_{0};
+  std::int64_t frame_allocations_ = 0;
+
+  Statistics frames_;
+};
+
+}  // namespace journal
+}  // namespace principia
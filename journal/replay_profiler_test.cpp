@@ -0,0 +1,91 @@
+﻿
+#include "journal/replay_profiler.hpp"
+
+#include <chrono>
+#include <sstream>
+#include <string>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "serialization/journal.pb.h"
+
+namespace principia {
+namespace journal {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+using namespace std::chrono_literals;
+
+class ReplayProfilerTest : public ::testing::Test {
+ protected:
+  ReplayProfilerTest() {
+    advance_time_.MutableExtension(serialization::AdvanceTime::extension);
+    get_version_.MutableExtension(serialization::GetVersion::extension);
+    set_buffered_logging_.MutableExtension(
+        serialization::SetBufferedLogging::extension);
+  }
+
+  static std::string Report(ReplayProfiler const& profiler) {
+    std::stringstream report;
+    profiler.WriteReport(report);
+    return report.str();
+  }
+
+  serialization::Method advance_time_;
+  serialization::Method get_version_;
+  serialization::Method set_buffered_logging_;
+};
+
+TEST_F(ReplayProfilerTest, Methods) {
+  ReplayProfiler profiler;
+  profiler.Record(get_version_, 3us, /*allocations=*/0);
+  profiler.Record(advance_time_, 5ms, /*allocations=*/0);
+  profiler.Record(advance_time_, 7ms, /*allocations=*/0);
+  std::string const report = Report(profiler);
+  EXPECT_THAT(report, HasSubstr("Replayed 2 distinct methods in 12.003 ms\n"));
+  // Ordered by decreasing total time.
+  EXPECT_THAT(report,
+              HasSubstr("principia__AdvanceTime (99.975% of total)\n"
+                        "  count: 2, total: 12.000 ms, mean: 6.000 ms, "
+                        "p50 ≤ 7.000 ms, p99 ≤ 7.000 ms, max: 7.000 ms\n"
+                        "  < 8.389 ms: 2\n"
+                        "principia__GetVersion (0.025% of total)\n"
+                        "  count: 1, total: 3.000 µs, mean: 3.000 µs, "
+                        "p50 ≤ 3.000 µs, p99 ≤ 3.000 µs, max: 3.000 µs\n"
+                        "  < 4.096 µs: 1\n"));
+  // Both calls to |principia__AdvanceTime| start a frame.
+  EXPECT_THAT(report,
+              HasSubstr("Frames\n"
+                        "  count: 2, total: 12.000 ms, mean: 6.000 ms, "
+                        "p50 ≤ 7.000 ms, p99 ≤ 7.000 ms, max: 7.000 ms\n"));
+  // No allocation counter.
+  EXPECT_THAT(report, Not(HasSubstr("allocations")));
+}
+
+TEST_F(ReplayProfilerTest, Frames) {
+  ReplayProfiler profiler([]() { return 0; });
+  // Not part of a frame.
+  profiler.Record(get_version_, 1ms, /*allocations=*/1);
+  // First frame.
+  profiler.Record(advance_time_, 2ms, /*allocations=*/2);
+  profiler.Record(set_buffered_logging_, 1ms, /*allocations=*/3);
+  // Second frame, not terminated.
+  profiler.Record(advance_time_, 5ms, /*allocations=*/4);
+  std::string const report = Report(profiler);
+  EXPECT_THAT(report,
+              HasSubstr("principia__SetBufferedLogging (11.111% of total)\n"
+                        "  count: 1, total: 1.000 ms, mean: 1.000 ms, "
+                        "p50 ≤ 1.000 ms, p99 ≤ 1.000 ms, max: 1.000 ms\n"
+                        "  allocations: 3, mean: 3.0, max: 3\n"));
+  // The frames last 3 ms and 5 ms.
+  EXPECT_THAT(report,
+              HasSubstr("Frames\n"
+                        "  count: 2, total: 8.000 ms, mean: 4.000 ms, "
+                        "p50 ≤ 4.194 ms, p99 ≤ 5.000 ms, max: 5.000 ms\n"
+                        "  allocations: 9, mean: 4.5, max: 5\n"
+                        "  < 4.194 ms: 1\n"
+                        "  < 8.389 ms: 1\n"));
+}
+
+}  // namespace journal
+}  // namespace principia
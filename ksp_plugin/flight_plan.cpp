@@ -50,13 +50,15 @@ FlightPlan::FlightPlan(
     not_null<Ephemeris<Barycentric>*> const ephemeris,
     Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters,
     Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters
-        generalized_adaptive_step_parameters)
+        generalized_adaptive_step_parameters,
+    WorkStealingThreadPool* const analysis_thread_pool)
     : initial_mass_(initial_mass),
       initial_time_(initial_time),
       initial_degrees_of_freedom_(std::move(initial_degrees_of_freedom)),
       desired_final_time_(desired_final_time),
       root_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()),
       ephemeris_(ephemeris),
+      analysis_thread_pool_(analysis_thread_pool),
       adaptive_step_parameters_(std::move(adaptive_step_parameters)),
       generalized_adaptive_step_parameters_(
           std::move(generalized_adaptive_step_parameters)) {
@@ -68,7 +70,7 @@ FlightPlan::FlightPlan(
   // Create a fork for the first coasting trajectory.
   segments_.emplace_back(root_->NewForkWithoutCopy(initial_time_));
   coast_analysers_.push_back(make_not_null_unique<OrbitAnalyser>(
-      ephemeris_, DefaultHistoryParameters()));
+      ephemeris_, DefaultHistoryParameters(), analysis_thread_pool_));
   CHECK(manœuvres_.empty());
   ComputeSegments(manœuvres_.begin(), manœuvres_.end());
 }
@@ -116,7 +118,9 @@ Status FlightPlan::Insert(NavigationManœuvre::Burn const& burn,
   manœuvres_.insert(manœuvres_.begin() + index, manœuvre);
   coast_analysers_.insert(coast_analysers_.begin() + index + 1,
                           make_not_null_unique<OrbitAnalyser>(
-                              ephemeris_, DefaultHistoryParameters()));
+                              ephemeris_,
+                              DefaultHistoryParameters(),
+                              analysis_thread_pool_));
   UpdateInitialMassOfManœuvresAfter(index);
   PopSegmentsAffectedByManœuvre(index);
   return ComputeSegments(manœuvres_.begin() + index, manœuvres_.end());
@@ -253,8 +257,17 @@ void FlightPlan::WriteToMessage(
 
 std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
     serialization::FlightPlan const& message,
-    not_null<Ephemeris<Barycentric>*> const ephemeris) {
+    not_null<Ephemeris<Barycentric>*> const ephemeris,
+    WorkStealingThreadPool* const analysis_thread_pool) {
   Instant initial_time = Instant::ReadFromMessage(message.initial_time());
+  // The segments are recomputed from the initial time, so the ephemeris must
+  // have been reanimated back to it.
+  Status const reanimation_status = ephemeris->AwaitReanimation(initial_time);
+  if (!reanimation_status.ok()) {
+    LOG(ERROR) << "Dropping the flight plan starting at " << initial_time
+               << ": " << reanimation_status;
+    return nullptr;
+  }
   std::unique_ptr<DegreesOfFreedom<Barycentric>> initial_degrees_of_freedom;
   CHECK(message.has_adaptive_step_parameters());
   auto const adaptive_step_parameters =
@@ -289,14 +302,17 @@ std::unique_ptr<FlightPlan> FlightPlan::ReadFromMessage(
       Instant::ReadFromMessage(message.desired_final_time()),
       ephemeris,
       *adaptive_step_parameters,
-      *generalized_adaptive_step_parameters);
+      *generalized_adaptive_step_parameters,
+      analysis_thread_pool);
 
   for (int i = 0; i < message.manoeuvre_size(); ++i) {
     auto const& manoeuvre = message.manoeuvre(i);
     flight_plan->manœuvres_.push_back(
         NavigationManœuvre::ReadFromMessage(manoeuvre, ephemeris));
     flight_plan->coast_analysers_.push_back(make_not_null_unique<OrbitAnalyser>(
-        flight_plan->ephemeris_, DefaultHistoryParameters()));
+        flight_plan->ephemeris_,
+        DefaultHistoryParameters(),
+        flight_plan->analysis_thread_pool_));
   }
   // We need to forcefully prolong, otherwise we might exceed the ephemeris
   // step limit while recomputing the segments and make the flight plan
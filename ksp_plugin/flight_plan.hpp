@@ -24,6 +24,7 @@ namespace internal_flight_plan {
 using base::Error;
 using base::not_null;
 using base::Status;
+using base::WorkStealingThreadPool;
 using geometry::Instant;
 using integrators::AdaptiveStepSizeIntegrator;
 using physics::DegreesOfFreedom;
@@ -41,7 +42,8 @@ class FlightPlan {
   // |initial_degrees_of_freedom| and with the given |initial_mass|.  The
   // trajectories are computed using the given parameters by the given
   // |ephemeris|.  The flight plan contains a single coast which, if possible
-  // ends at |desired_final_time|.
+  // ends at |desired_final_time|.  The coasts are analysed using the
+  // |analysis_thread_pool|, see |OrbitAnalyser|.
   FlightPlan(Mass const& initial_mass,
              Instant const& initial_time,
              DegreesOfFreedom<Barycentric> initial_degrees_of_freedom,
@@ -50,7 +52,8 @@ class FlightPlan {
              Ephemeris<Barycentric>::AdaptiveStepParameters
                  adaptive_step_parameters,
              Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters
-                 generalized_adaptive_step_parameters);
+                 generalized_adaptive_step_parameters,
+             WorkStealingThreadPool* analysis_thread_pool = nullptr);
   virtual ~FlightPlan() = default;
 
   // Construction parameters.
@@ -128,10 +131,12 @@ class FlightPlan {
   void WriteToMessage(not_null<serialization::FlightPlan*> message) const;
 
   // This may return a null pointer if the flight plan contained in the
-  // |message| is anomalous.
+  // |message| is anomalous, or if the |ephemeris| cannot be reanimated back to
+  // its initial time.
   static std::unique_ptr<FlightPlan> ReadFromMessage(
       serialization::FlightPlan const& message,
-      not_null<Ephemeris<Barycentric>*> ephemeris);
+      not_null<Ephemeris<Barycentric>*> ephemeris,
+      WorkStealingThreadPool* analysis_thread_pool = nullptr);
 
   static constexpr std::int64_t max_ephemeris_steps_per_frame = 1000;
 
@@ -219,6 +224,7 @@ class FlightPlan {
   std::vector<NavigationManœuvre> manœuvres_;
   std::vector<not_null<std::unique_ptr<OrbitAnalyser>>> coast_analysers_;
   not_null<Ephemeris<Barycentric>*> ephemeris_;
+  WorkStealingThreadPool* analysis_thread_pool_ = nullptr;
   Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters_;
   Ephemeris<Barycentric>::GeneralizedAdaptiveStepParameters
       generalized_adaptive_step_parameters_;
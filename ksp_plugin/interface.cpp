@@ -325,8 +325,22 @@ void __cdecl principia__ActivateRecorder(bool const activate) {
     std::tm* const localtime = std::localtime(&time);
     std::stringstream name;
     name << std::put_time(localtime, "JOURNAL.%Y%m%d-%H%M%S");
-    journal::Recorder* const recorder = new journal::Recorder(
-        std::filesystem::path("glog") / "Principia" / name.str());
+    auto const path = std::filesystem::path("glog") / "Principia" / name.str();
+    // A binary journal, possibly compressed, may be requested with flags:
+    //   principia_flags {
+    //     journal_format = binary
+    //     journal_compressor = gipfeli
+    //   }
+    journal::Recorder* recorder;
+    if (Flags::IsPresent("journal_format", "binary")) {
+      auto const compressors = Flags::Values("journal_compressor");
+      recorder = new journal::Recorder(
+          path,
+          journal::Recorder::Format::Binary,
+          NewCompressor(compressors.empty() ? "" : *compressors.begin()));
+    } else {
+      recorder = new journal::Recorder(path);
+    }
     Vessel::MakeSynchronous();
     journal::Recorder::Activate(recorder);
   } else if (!activate && journal::Recorder::IsActivated()) {
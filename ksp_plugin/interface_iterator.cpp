@@ -76,6 +76,24 @@ XYZ __cdecl principia__IteratorGetDiscreteTrajectoryXYZ(
       }));
 }
 
+int __cdecl principia__IteratorGetDiscreteTrajectoryXYZs(
+    Iterator* const iterator,
+    XYZ* const xyzs,
+    int const size) {
+  journal::Method<journal::IteratorGetDiscreteTrajectoryXYZs> m(
+      {iterator, xyzs, size});
+  CHECK_NOTNULL(iterator);
+  CHECK_NOTNULL(xyzs);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<DiscreteTrajectory<World>>*>(iterator));
+  return m.Return(typed_iterator->Fill(
+      xyzs,
+      size,
+      [](DiscreteTrajectory<World>::Iterator const& iterator) -> XYZ {
+        return ToXYZ(iterator->degrees_of_freedom.position());
+      }));
+}
+
 Iterator* __cdecl principia__IteratorGetRP2LinesIterator(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LinesIterator> m({iterator});
@@ -88,6 +106,19 @@ Iterator* __cdecl principia__IteratorGetRP2LinesIterator(
       }));
 }
 
+Iterator* __cdecl principia__IteratorGetRP2LinesListIterator(
+    Iterator const* const iterator) {
+  journal::Method<journal::IteratorGetRP2LinesListIterator> m({iterator});
+  CHECK_NOTNULL(iterator);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<std::vector<RP2Lines<Length, Camera>>> const*>(
+          iterator));
+  return m.Return(typed_iterator->Get<Iterator*>(
+      [](RP2Lines<Length, Camera> const& rp2_lines) -> Iterator* {
+        return new TypedIterator<RP2Lines<Length, Camera>>(rp2_lines);
+      }));
+}
+
 XY __cdecl principia__IteratorGetRP2LineXY(Iterator const* const iterator) {
   journal::Method<journal::IteratorGetRP2LineXY> m({iterator});
   CHECK_NOTNULL(iterator);
@@ -99,6 +130,22 @@ XY __cdecl principia__IteratorGetRP2LineXY(Iterator const* const iterator) {
       }));
 }
 
+int __cdecl principia__IteratorGetRP2LineXYs(Iterator* const iterator,
+                                             XY* const xys,
+                                             int const size) {
+  journal::Method<journal::IteratorGetRP2LineXYs> m({iterator, xys, size});
+  CHECK_NOTNULL(iterator);
+  CHECK_NOTNULL(xys);
+  auto const typed_iterator = check_not_null(
+      dynamic_cast<TypedIterator<RP2Line<Length, Camera>>*>(iterator));
+  return m.Return(typed_iterator->Fill(
+      xys,
+      size,
+      [](RP2Point<Length, Camera> const& rp2_point) -> XY {
+        return ToXY(rp2_point);
+      }));
+}
+
 char const* __cdecl principia__IteratorGetVesselGuid(
     Iterator const* const iterator) {
   journal::Method<journal::IteratorGetVesselGuid> m({iterator});
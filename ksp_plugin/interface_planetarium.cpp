@@ -2,6 +2,8 @@
 #include "ksp_plugin/interface.hpp"
 
 #include <algorithm>
+#include <optional>
+#include <vector>
 
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
@@ -38,11 +40,62 @@ using ksp_plugin::Renderer;
 using ksp_plugin::TypedIterator;
 using physics::DiscreteTrajectory;
 using quantities::Length;
+using quantities::Time;
 using quantities::si::ArcMinute;
 using quantities::si::Kilo;
 using quantities::si::Metre;
 using quantities::si::Radian;
 
+namespace {
+
+// Returns a job that plots the points from |begin| to |end| that lie in the
+// range of |plotting_frame|, like the overload of |PlotMethod2| on iterators.
+// If there are no such points, the job plots nothing.
+Planetarium::PlotMethod2Job MakePlotMethod2Job(
+    NavigationFrame const& plotting_frame,
+    DiscreteTrajectory<Barycentric>::Iterator const& begin,
+    DiscreteTrajectory<Barycentric>::Iterator const& end,
+    Instant const& now,
+    bool const reverse) {
+  auto const& trajectory = *begin.trajectory();
+  if (begin == end) {
+    return {&trajectory, now, now, reverse};
+  }
+  auto last = end;
+  --last;
+  return {&trajectory,
+          std::max(begin->time, plotting_frame.t_min()),
+          std::min(last->time, plotting_frame.t_max()),
+          reverse};
+}
+
+// Appends to |jobs| the jobs that plot the psychohistory and the prediction of
+// |vessel|.  The psychohistory goes back |max_history_length| before |now|, and
+// is empty if |plot_psychohistory| is false.
+void AddVesselJobs(NavigationFrame const& plotting_frame,
+                   Vessel const& vessel,
+                   Time const& max_history_length,
+                   Instant const& now,
+                   bool const plot_psychohistory,
+                   std::vector<Planetarium::PlotMethod2Job>& jobs) {
+  auto const& psychohistory = vessel.psychohistory();
+  jobs.push_back(MakePlotMethod2Job(
+      plotting_frame,
+      plot_psychohistory ? psychohistory.LowerBound(now - max_history_length)
+                         : psychohistory.end(),
+      psychohistory.end(),
+      now,
+      /*reverse=*/true));
+  auto const& prediction = vessel.prediction();
+  jobs.push_back(MakePlotMethod2Job(plotting_frame,
+                                    prediction.Fork(),
+                                    prediction.end(),
+                                    now,
+                                    /*reverse=*/false));
+}
+
+}  // namespace
+
 Planetarium* __cdecl principia__PlanetariumCreate(
     Plugin const* const plugin,
     XYZ const sun_world_position,
@@ -182,6 +235,124 @@ Iterator* __cdecl principia__PlanetariumPlotPsychohistory(
   }
 }
 
+// Plots all the trajectories of the map view in one batch, and returns an
+// iterator over them, in the following order:
+// 1. for each of the |celestial_indices|, the past trajectory of the celestial
+//    and its future trajectory, as computed by
+//    |PlanetariumPlotCelestialTrajectoryForPsychohistory| and
+//    |PlanetariumPlotCelestialTrajectoryForPredictionOrFlightPlan|; the future
+//    trajectory is empty if |main_vessel_guid| is null;
+// 2. if |main_vessel_guid| is not null, the psychohistory and the prediction of
+//    that vessel, then, if |target_vessel_guid| is not null, those of the
+//    target vessel, then, if the main vessel has a flight plan, its segments,
+//    as computed by |PlanetariumPlotFlightPlanSegment|.
+// The psychohistories go back |max_history_length| seconds before the present
+// time, and, like the past trajectories of the celestials, are empty when there
+// is a target vessel.
+Iterator* __cdecl principia__PlanetariumPlotTrajectories(
+    Planetarium const* const planetarium,
+    Plugin const* const plugin,
+    char const* const main_vessel_guid,
+    char const* const target_vessel_guid,
+    int const* const celestial_indices,
+    int const number_of_celestials,
+    double const max_history_length) {
+  journal::Method<journal::PlanetariumPlotTrajectories> m(
+      {planetarium,
+       plugin,
+       main_vessel_guid,
+       target_vessel_guid,
+       celestial_indices,
+       number_of_celestials,
+       max_history_length});
+  CHECK_NOTNULL(plugin);
+  CHECK_NOTNULL(planetarium);
+  CHECK(number_of_celestials == 0 || celestial_indices != nullptr);
+  auto const& plotting_frame = *plugin->renderer().GetPlottingFrame();
+  Instant const now = plugin->CurrentTime();
+
+  // Do not plot the past when there is a target vessel as it is misleading.
+  bool const plot_past = !plugin->renderer().HasTargetVessel();
+  Vessel const* const main_vessel =
+      main_vessel_guid == nullptr ? nullptr
+                                  : plugin->GetVessel(main_vessel_guid);
+  std::vector<Planetarium::PlotMethod2Job> jobs;
+
+  // The future trajectories of the celestials go as far as the furthest of the
+  // final time of the prediction or that of the flight plan.
+  std::optional<Instant> celestial_final_time;
+  if (main_vessel != nullptr && plot_past) {
+    Instant const prediction_final_time = main_vessel->prediction().t_max();
+    celestial_final_time =
+        main_vessel->has_flight_plan()
+            ? std::max(main_vessel->flight_plan().actual_final_time(),
+                       prediction_final_time)
+            : prediction_final_time;
+  }
+  for (int i = 0; i < number_of_celestials; ++i) {
+    auto const& celestial_trajectory =
+        plugin->GetCelestial(celestial_indices[i]).trajectory();
+    if (plot_past) {
+      jobs.push_back({&celestial_trajectory,
+                      std::max(now - max_history_length * Second,
+                               celestial_trajectory.t_min()),
+                      now,
+                      /*reverse=*/true});
+    } else {
+      jobs.push_back({&celestial_trajectory, now, now, /*reverse=*/true});
+    }
+    jobs.push_back({&celestial_trajectory,
+                    now,
+                    celestial_final_time.value_or(now),
+                    /*reverse=*/false});
+  }
+
+  if (main_vessel != nullptr) {
+    AddVesselJobs(plotting_frame,
+                  *main_vessel,
+                  max_history_length * Second,
+                  now,
+                  plot_past,
+                  jobs);
+    if (target_vessel_guid != nullptr) {
+      AddVesselJobs(plotting_frame,
+                    *plugin->GetVessel(target_vessel_guid),
+                    max_history_length * Second,
+                    now,
+                    plot_past,
+                    jobs);
+    }
+    if (main_vessel->has_flight_plan()) {
+      auto const& flight_plan = main_vessel->flight_plan();
+      for (int index = 0; index < flight_plan.number_of_segments(); ++index) {
+        DiscreteTrajectory<Barycentric>::Iterator segment_begin;
+        DiscreteTrajectory<Barycentric>::Iterator segment_end;
+        flight_plan.GetSegment(index, segment_begin, segment_end);
+        // Same rule as in |PlanetariumPlotFlightPlanSegment|: a burn whose
+        // beginning cannot be rendered is not rendered at all.
+        if (index % 2 == 0 ||
+            segment_begin == segment_end ||
+            segment_begin->time >= plotting_frame.t_min()) {
+          jobs.push_back(MakePlotMethod2Job(plotting_frame,
+                                            segment_begin,
+                                            segment_end,
+                                            now,
+                                            /*reverse=*/false));
+        } else {
+          jobs.push_back(MakePlotMethod2Job(plotting_frame,
+                                            segment_end,
+                                            segment_end,
+                                            now,
+                                            /*reverse=*/false));
+        }
+      }
+    }
+  }
+
+  return m.Return(new TypedIterator<std::vector<RP2Lines<Length, Camera>>>(
+      planetarium->PlotMethod2(jobs, now)));
+}
+
 // Returns an iterator for the rendered past trajectory of the celestial with
 // the given index; the trajectory goes back |max_history_length| seconds before
 // the present time (or to the earliest time available if the relevant |t_min|
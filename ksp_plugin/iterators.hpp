@@ -37,6 +37,13 @@ class TypedIterator : public Iterator {
       std::function<Interchange(typename Container::value_type const&)> const&
           convert) const;
 
+  // Converts at most |size| elements starting at the one denoted by this
+  // iterator using |convert| and stores them in |interchanges|.  Advances this
+  // iterator past the converted elements and returns their number, which is
+  // less than |size| only if the end of the container is reached.
+  template<typename Interchange, typename Convert>
+  int Fill(Interchange* interchanges, int size, Convert const& convert);
+
   bool AtEnd() const override;
   void Increment() override;
   void Reset() override;
@@ -61,6 +68,10 @@ class TypedIterator<DiscreteTrajectory<World>> : public Iterator {
       std::function<Interchange(
           DiscreteTrajectory<World>::Iterator const&)> const& convert) const;
 
+  // Same as above, but |convert| takes a |DiscreteTrajectory<World>::Iterator|.
+  template<typename Interchange, typename Convert>
+  int Fill(Interchange* interchanges, int size, Convert const& convert);
+
   bool AtEnd() const override;
   void Increment() override;
   void Reset() override;
@@ -22,6 +22,19 @@ Interchange TypedIterator<Container>::Get(
   return convert(*iterator_);
 }
 
+template<typename Container>
+template<typename Interchange, typename Convert>
+int TypedIterator<Container>::Fill(Interchange* const interchanges,
+                                   int const size,
+                                   Convert const& convert) {
+  CHECK_LE(0, size);
+  int filled = 0;
+  for (; filled < size && iterator_ != container_.end(); ++iterator_) {
+    interchanges[filled++] = convert(*iterator_);
+  }
+  return filled;
+}
+
 template<typename Container>
 bool TypedIterator<Container>::AtEnd() const {
   return iterator_ == container_.end();
@@ -59,6 +72,19 @@ Interchange TypedIterator<DiscreteTrajectory<World>>::Get(
   return convert(iterator_);
 }
 
+template<typename Interchange, typename Convert>
+int TypedIterator<DiscreteTrajectory<World>>::Fill(
+    Interchange* const interchanges,
+    int const size,
+    Convert const& convert) {
+  CHECK_LE(0, size);
+  int filled = 0;
+  for (; filled < size && iterator_ != trajectory_->end(); ++iterator_) {
+    interchanges[filled++] = convert(iterator_);
+  }
+  return filled;
+}
+
 inline bool TypedIterator<DiscreteTrajectory<World>>::AtEnd() const {
   return iterator_ == trajectory_->end();
 }
@@ -27,10 +27,12 @@ using quantities::Infinity;
 
 OrbitAnalyser::OrbitAnalyser(
     not_null<Ephemeris<Barycentric>*> const ephemeris,
-    Ephemeris<Barycentric>::FixedStepParameters analysed_trajectory_parameters)
+    Ephemeris<Barycentric>::FixedStepParameters analysed_trajectory_parameters,
+    WorkStealingThreadPool* const thread_pool)
     : ephemeris_(ephemeris),
       analysed_trajectory_parameters_(
-          std::move(analysed_trajectory_parameters)) {}
+          std::move(analysed_trajectory_parameters)),
+      thread_pool_(thread_pool) {}
 
 OrbitAnalyser::~OrbitAnalyser() {
   // Ensure that we do not have a thread still running with references to the
@@ -151,8 +153,10 @@ Status OrbitAnalyser::AnalyseOrbit(GuardedParameters const guarded_parameters) {
           time, body_centred.ToThisFrameAtTime(time)(degrees_of_freedom));
     }
     analysis.primary_ = primary;
-    auto elements = OrbitalElements::ForTrajectory(
-        primary_centred_trajectory, *primary, MasslessBody{});
+    auto elements = OrbitalElements::ForTrajectory(primary_centred_trajectory,
+                                                   *primary,
+                                                   MasslessBody{},
+                                                   thread_pool_);
     // We do not RETURN_IF_ERROR as ForTrajectory can return non-CANCELLED
     // statuses.
     RETURN_IF_STOPPED;
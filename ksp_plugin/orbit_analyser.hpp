@@ -10,6 +10,7 @@
 #include "astronomy/orbital_elements.hpp"
 #include "base/jthread.hpp"
 #include "base/not_null.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "geometry/named_quantities.hpp"
 #include "ksp_plugin/frames.hpp"
 #include "physics/degrees_of_freedom.hpp"
@@ -27,6 +28,7 @@ using astronomy::OrbitRecurrence;
 using base::jthread;
 using base::not_null;
 using base::Status;
+using base::WorkStealingThreadPool;
 using geometry::Instant;
 using physics::DegreesOfFreedom;
 using physics::Ephemeris;
@@ -94,9 +96,12 @@ class OrbitAnalyser {
     std::optional<Time> extended_mission_duration;
   };
 
+  // The orbital elements are computed in parallel on |thread_pool|, which must
+  // outlive this object, if it is not null, sequentially otherwise.
   OrbitAnalyser(not_null<Ephemeris<Barycentric>*> ephemeris,
                 Ephemeris<Barycentric>::FixedStepParameters
-                    analysed_trajectory_parameters);
+                    analysed_trajectory_parameters,
+                WorkStealingThreadPool* thread_pool = nullptr);
 
   virtual ~OrbitAnalyser();
 
@@ -133,6 +138,7 @@ class OrbitAnalyser {
   not_null<Ephemeris<Barycentric>*> const ephemeris_;
   Ephemeris<Barycentric>::FixedStepParameters const
       analysed_trajectory_parameters_;
+  WorkStealingThreadPool* const thread_pool_;
 
   std::optional<Parameters> last_parameters_;
 
@@ -7,6 +7,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 #include "base/map_util.hpp"
 #include "geometry/identity.hpp"
@@ -104,6 +105,7 @@ PileUp::PileUp(
 
 PileUp::~PileUp() {
   LOG(INFO) << "Destroying pile up at " << this;
+  LeaveHistoryBatch(/*continue_integration=*/false);
   if (deletion_callback_ != nullptr) {
     deletion_callback_();
   }
@@ -124,6 +126,12 @@ void PileUp::SetPartApparentRigidMotion(
 
 Status PileUp::DeformAndAdvanceTime(Instant const& t) {
   absl::MutexLock l(lock_.get());
+  auto const unclaimed = [this]() { return !claimed_; };
+  lock_->Await(absl::Condition(&unclaimed));
+  return DeformAndAdvanceTimeLocked(t);
+}
+
+Status PileUp::DeformAndAdvanceTimeLocked(Instant const& t) {
   Status status;
   if (psychohistory_->back().time < t) {
     DeformPileUpIfNeeded(t);
@@ -133,6 +141,237 @@ Status PileUp::DeformAndAdvanceTime(Instant const& t) {
   return status;
 }
 
+std::vector<std::vector<not_null<PileUp*>>> PileUp::MakeBatches(
+    std::list<PileUp*> const& pile_ups) {
+  std::vector<std::vector<not_null<PileUp*>>> batches;
+  // The members of the existing batches that are still usable.
+  std::map<HistoryBatch const*, std::vector<not_null<PileUp*>>> existing;
+  // The pile-ups in free fall that don't belong to a usable batch, grouped by
+  // the time at which their history ends.
+  std::map<Instant, std::vector<not_null<PileUp*>>> free_falling;
+  // The pile-ups subject to an intrinsic force are integrated by themselves.
+  // They leave their batch first, so that it is not reused by the others.
+  std::vector<not_null<PileUp*>> candidates;
+  for (PileUp* const pile_up : pile_ups) {
+    absl::MutexLock l(pile_up->lock_.get());
+    if (pile_up->intrinsic_force_ == Vector<Force, Barycentric>{}) {
+      candidates.push_back(pile_up);
+    } else {
+      // The history will be integrated with an adaptive step.
+      pile_up->LeaveHistoryBatch(/*continue_integration=*/false);
+      batches.push_back({pile_up});
+    }
+  }
+  for (not_null<PileUp*> const pile_up : candidates) {
+    absl::MutexLock l(pile_up->lock_.get());
+    if (pile_up->history_batch_ != nullptr &&
+        !pile_up->history_batch_->broken) {
+      existing[pile_up->history_batch_.get()].push_back(pile_up);
+    } else {
+      // Retrieve the instance that integrates our history, if any.
+      pile_up->LeaveHistoryBatch(/*continue_integration=*/true);
+      free_falling[pile_up->history_->back().time].push_back(pile_up);
+    }
+  }
+
+  for (auto& [history_batch, members] : existing) {
+    // A member that left the batch broke it, so all the members are present.
+    CHECK_EQ(history_batch->size, members.size());
+    batches.push_back(std::move(members));
+  }
+
+  for (auto& [_, group] : free_falling) {
+    while (!group.empty()) {
+      // The pile-ups that have an instance may only be batched together, so
+      // that the instance of the batch can be merged from theirs.
+      PileUp const& front = *group.front();
+      auto const& parameters = front.fixed_step_parameters_;
+      bool const has_instance = front.fixed_instance_ != nullptr;
+      auto const same_parameters_end = std::stable_partition(
+          group.begin(), group.end(),
+          [&parameters, has_instance](not_null<PileUp*> const pile_up) {
+            return &pile_up->fixed_step_parameters_.integrator() ==
+                       &parameters.integrator() &&
+                   pile_up->fixed_step_parameters_.step() ==
+                       parameters.step() &&
+                   (pile_up->fixed_instance_ != nullptr) == has_instance;
+          });
+      std::vector<not_null<PileUp*>> batch(group.begin(), same_parameters_end);
+      group.erase(group.begin(), same_parameters_end);
+      if (batch.size() > 1) {
+        // The instance of the batch is created at the first integration.
+        // Until then the members keep their own instances, if any.
+        auto const history_batch = std::make_shared<HistoryBatch>();
+        history_batch->size = batch.size();
+        for (not_null<PileUp*> const pile_up : batch) {
+          absl::MutexLock l(pile_up->lock_.get());
+          pile_up->history_batch_ = history_batch;
+        }
+      }
+      batches.push_back(std::move(batch));
+    }
+  }
+  return batches;
+}
+
+std::vector<Status> PileUp::DeformAndAdvanceTime(
+    std::vector<not_null<PileUp*>> const& batch,
+    Instant const& t,
+    WorkStealingThreadPool& thread_pool) {
+  std::int64_t const size = batch.size();
+  std::vector<Status> statuses(size);
+
+  // The members are claimed by this call for its entire duration, so that no
+  // other call to |DeformAndAdvanceTime| may change their state between the
+  // steps below.  Each step still locks the members that it accesses: the
+  // computations specific to a member lock it on the thread that executes
+  // them, the computations on the whole batch lock all the members.
+  auto const lock_all = [&batch]() {
+    for (not_null<PileUp*> const pile_up : batch) {
+      pile_up->lock_->Lock();
+    }
+  };
+  auto const unlock_all = [&batch]() {
+    for (not_null<PileUp*> const pile_up : batch) {
+      pile_up->lock_->Unlock();
+    }
+  };
+
+  std::shared_ptr<HistoryBatch> history_batch;
+  bool integrate_together = size > 1;
+  for (not_null<PileUp*> const pile_up : batch) {
+    absl::MutexLock l(pile_up->lock_.get());
+    pile_up->Claim();
+    // The batch may only be integrated together if nothing happened to its
+    // members since it was made.  Otherwise, or if there is nothing to share,
+    // each pile-up is processed separately.
+    if (pile_up == batch.front()) {
+      history_batch = pile_up->history_batch_;
+      integrate_together &= history_batch != nullptr &&
+                            !history_batch->broken &&
+                            history_batch->size == size;
+    }
+    integrate_together &=
+        pile_up->history_batch_ == history_batch &&
+        pile_up->intrinsic_force_ == Vector<Force, Barycentric>{} &&
+        pile_up->psychohistory_->back().time < t;
+  }
+
+  // All the pile-ups share the same ephemeris and parameters.
+  PileUp const& first = *batch.front();
+  std::vector<not_null<DiscreteTrajectory<Barycentric>*>> histories;
+  for (not_null<PileUp*> const pile_up : batch) {
+    histories.push_back(pile_up->history_.get());
+  }
+
+  // If the members have instances, the instance of the batch continues their
+  // integrations.  This is only possible if they are in the same state, in
+  // particular if none of them is starting up; otherwise the members are
+  // integrated separately until they are.
+  lock_all();
+  std::unique_ptr<typename Integrator<
+      Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
+      merged_instance;
+  if (integrate_together && history_batch->instance == nullptr &&
+      first.fixed_instance_ != nullptr) {
+    std::vector<not_null<typename Integrator<
+        Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance const*>>
+        instances;
+    for (not_null<PileUp*> const pile_up : batch) {
+      instances.push_back(pile_up->fixed_instance_.get());
+    }
+    merged_instance = first.ephemeris_->MergeInstances(instances, histories);
+    integrate_together = merged_instance != nullptr;
+  }
+
+  if (!integrate_together) {
+    // Leaving the batch may split its instance, which reads the histories of
+    // all the members, so it is done here rather than in |AdvanceTime|.
+    for (not_null<PileUp*> const pile_up : batch) {
+      if (pile_up->psychohistory_->back().time < t) {
+        pile_up->LeaveHistoryBatch(
+            /*continue_integration=*/pile_up->intrinsic_force_ ==
+            Vector<Force, Barycentric>{});
+      }
+    }
+    unlock_all();
+    thread_pool.ParallelFor(
+        0, size,
+        [&batch, &statuses, &t](std::int64_t const i) {
+          PileUp& pile_up = *batch[i];
+          absl::MutexLock l(pile_up.lock_.get());
+          statuses[i] = pile_up.DeformAndAdvanceTimeLocked(t);
+          pile_up.Release();
+        });
+    return statuses;
+  }
+  unlock_all();
+
+  std::vector<DiscreteTrajectory<Barycentric>::Iterator> history_lasts(size);
+  thread_pool.ParallelFor(
+      0, size,
+      [&batch, &history_lasts, &t](std::int64_t const i) {
+        PileUp& pile_up = *batch[i];
+        absl::MutexLock l(pile_up.lock_.get());
+        CHECK_NOTNULL(pile_up.psychohistory_);
+        pile_up.DeformPileUpIfNeeded(t);
+        history_lasts[i] = --pile_up.history_->end();
+        pile_up.history_->DeleteFork(pile_up.psychohistory_);
+      });
+
+  lock_all();
+  if (history_batch->instance == nullptr) {
+    if (merged_instance == nullptr) {
+      history_batch->instance = first.ephemeris_->NewInstance(
+          histories,
+          Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+          first.fixed_step_parameters_);
+    } else {
+      history_batch->instance = std::move(merged_instance);
+    }
+    absl::MutexLock l(&history_batch->lock);
+    // The instances of the members become stale as soon as the batch advances
+    // their histories; from now on, they are split from that of the batch if
+    // needed.
+    for (not_null<PileUp*> const pile_up : batch) {
+      history_batch->members.push_back(pile_up);
+      pile_up->fixed_instance_ = nullptr;
+    }
+  }
+  CHECK_LT(first.history_->back().time, t);
+  Status const batch_status =
+      first.ephemeris_->FlowWithFixedStep(t, *history_batch->instance);
+
+  // If the integration failed, some pile-up collided with a celestial but we
+  // don't know which.  The batch is dissolved and each pile-up resumes its
+  // integration separately from the last step, with an instance split from
+  // that of the batch, which tells us whose fault it was.
+  if (!batch_status.ok()) {
+    for (not_null<PileUp*> const pile_up : batch) {
+      pile_up->LeaveHistoryBatch(/*continue_integration=*/true);
+    }
+  }
+  unlock_all();
+
+  thread_pool.ParallelFor(
+      0, size,
+      [&batch, &batch_status, &history_lasts, &statuses, &t](
+          std::int64_t const i) {
+        PileUp& pile_up = *batch[i];
+        absl::MutexLock l(pile_up.lock_.get());
+        Status status;
+        if (!batch_status.ok()) {
+          status = pile_up.FlowHistoryWithFixedStep(t);
+        }
+        status.Update(pile_up.FlowPsychohistory(t));
+        pile_up.AppendToParts(history_lasts[i]);
+        pile_up.NudgeParts();
+        statuses[i] = status;
+        pile_up.Release();
+      });
+  return statuses;
+}
+
 void PileUp::RecomputeFromParts() {
   absl::MutexLock l(lock_.get());
   mass_ = Mass();
@@ -536,29 +775,17 @@ Status PileUp::AdvanceTime(Instant const& t) {
 
   Status status;
   auto const history_last = --history_->end();
-  if (intrinsic_force_ == Vector<Force, Barycentric>{}) {
+  bool const free_falling = intrinsic_force_ == Vector<Force, Barycentric>{};
+  // This pile-up is integrated by itself from now on.
+  LeaveHistoryBatch(/*continue_integration=*/free_falling);
+  if (free_falling) {
     // Remove the fork.
     history_->DeleteFork(psychohistory_);
-    if (fixed_instance_ == nullptr) {
-      fixed_instance_ = ephemeris_->NewInstance(
-          {history_.get()},
-          Ephemeris<Barycentric>::NoIntrinsicAccelerations,
-          fixed_step_parameters_);
-    }
     CHECK_LT(history_->back().time, t);
-    status = ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
-    psychohistory_ = history_->NewForkAtLast();
-    if (history_->back().time < t) {
-      // Do not clear the |fixed_instance_| here, we will use it for the next
-      // fixed-step integration.
-      status.Update(
-          ephemeris_->FlowWithAdaptiveStep(
-              psychohistory_,
-              Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-              t,
-              adaptive_step_parameters_,
-              Ephemeris<Barycentric>::unlimited_max_ephemeris_steps));
-    }
+    status = FlowHistoryWithFixedStep(t);
+    // Do not clear the |fixed_instance_| here, we will use it for the next
+    // fixed-step integration.
+    status.Update(FlowPsychohistory(t));
   } else {
     // Destroy the fixed instance, it wouldn't be correct to use it the next
     // time we go through this function.  It will be re-created as needed.
@@ -589,6 +816,36 @@ Status PileUp::AdvanceTime(Instant const& t) {
     psychohistory_ = history_->NewForkAtLast();
   }
 
+  AppendToParts(history_last);
+
+  return status;
+}
+
+Status PileUp::FlowHistoryWithFixedStep(Instant const& t) {
+  if (fixed_instance_ == nullptr) {
+    fixed_instance_ = ephemeris_->NewInstance(
+        {history_.get()},
+        Ephemeris<Barycentric>::NoIntrinsicAccelerations,
+        fixed_step_parameters_);
+  }
+  return ephemeris_->FlowWithFixedStep(t, *fixed_instance_);
+}
+
+Status PileUp::FlowPsychohistory(Instant const& t) {
+  psychohistory_ = history_->NewForkAtLast();
+  if (history_->back().time < t) {
+    return ephemeris_->FlowWithAdaptiveStep(
+        psychohistory_,
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        t,
+        adaptive_step_parameters_,
+        Ephemeris<Barycentric>::unlimited_max_ephemeris_steps);
+  }
+  return Status::OK;
+}
+
+void PileUp::AppendToParts(
+    DiscreteTrajectory<Barycentric>::Iterator const history_last) {
   CHECK_NOTNULL(psychohistory_);
 
   // Append the |history_| to the parts' history and the |psychohistory_| to the
@@ -605,8 +862,52 @@ Status PileUp::AdvanceTime(Instant const& t) {
     AppendToPart<&Part::AppendToPsychohistory>(it);
   }
   history_->ForgetBefore(psychohistory_->Fork()->time);
+}
 
-  return status;
+void PileUp::Claim() {
+  auto const unclaimed = [this]() { return !claimed_; };
+  lock_->Await(absl::Condition(&unclaimed));
+  claimed_ = true;
+}
+
+void PileUp::Release() {
+  CHECK(claimed_);
+  claimed_ = false;
+}
+
+void PileUp::LeaveHistoryBatch(bool const continue_integration) {
+  if (history_batch_ == nullptr) {
+    return;
+  }
+  HistoryBatch& history_batch = *history_batch_;
+  history_batch.broken = true;
+  if (history_batch.instance != nullptr) {
+    absl::MutexLock l(&history_batch.lock);
+    auto& members = history_batch.members;
+    auto const it = std::find(members.begin(), members.end(), this);
+    CHECK(it != members.end());
+    std::int64_t const index = it - members.begin();
+    if (continue_integration) {
+      // The first member to leave splits the instance for all the members that
+      // are still there.  The instance is not integrated anymore since the
+      // batch is broken, so it ends where all their histories end.
+      if (history_batch.split_instances.empty()) {
+        std::vector<DiscreteTrajectory<Barycentric>*> histories;
+        for (PileUp* const member : members) {
+          if (member == nullptr) {
+            histories.push_back(nullptr);
+          } else {
+            histories.push_back(member->history_.get());
+          }
+        }
+        history_batch.split_instances =
+            ephemeris_->SplitInstance(*history_batch.instance, histories);
+      }
+      fixed_instance_ = std::move(history_batch.split_instances[index]);
+    }
+    members[index] = nullptr;
+  }
+  history_batch_ = nullptr;
 }
 
 void PileUp::NudgeParts() const {
@@ -649,7 +950,7 @@ void PileUp::AppendToPart(DiscreteTrajectory<Barycentric>::Iterator it) const {
 }
 
 PileUpFuture::PileUpFuture(not_null<PileUp const*> const pile_up,
-                           std::future<Status> future)
+                           Task<Status> future)
     : pile_up(pile_up),
       future(std::move(future)) {}
 
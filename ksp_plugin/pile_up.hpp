@@ -1,17 +1,20 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
-#include <future>
 #include <list>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <vector>
 
 #include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
 #include "base/status.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "geometry/frame.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -36,6 +39,8 @@ namespace internal_pile_up {
 
 using base::not_null;
 using base::Status;
+using base::Task;
+using base::WorkStealingThreadPool;
 using geometry::Arbitrary;
 using geometry::Bivector;
 using geometry::Frame;
@@ -120,6 +125,26 @@ class PileUp {
   // not concurrently with any other method of this class.
   Status DeformAndAdvanceTime(Instant const& t);
 
+  // Partitions the |pile_ups| into batches that may be passed to the static
+  // |DeformAndAdvanceTime| below.  The pile-ups that are in free fall, have the
+  // same fixed-step parameters and whose histories end at the same time are put
+  // in the same batch.  A batch that was integrated together previously is
+  // preserved as long as none of its members left it, so that its integrator
+  // instance may be reused.  The other pile-ups are in batches of size 1.
+  static std::vector<std::vector<not_null<PileUp*>>> MakeBatches(
+      std::list<PileUp*> const& pile_ups);
+
+  // Same as calling |DeformAndAdvanceTime(t)| for each element of |batch|, but
+  // the histories are integrated together by a single fixed-step instance, so
+  // that the positions of the massive bodies are evaluated once per step for
+  // the entire batch.  The computations that are specific to each pile-up are
+  // parallelized on |thread_pool|.  Returns the status of each pile-up, in the
+  // order of |batch|.
+  static std::vector<Status> DeformAndAdvanceTime(
+      std::vector<not_null<PileUp*>> const& batch,
+      Instant const& t,
+      WorkStealingThreadPool& thread_pool);
+
   // Recomputes the state of motion of the pile-up based on that of its parts.
   void RecomputeFromParts();
 
@@ -168,12 +193,42 @@ class PileUp {
   // The degrees of freedom set by this method are used by |NudgeParts|.
   void DeformPileUpIfNeeded(Instant const& t);
 
+  // Same as |DeformAndAdvanceTime|, but |lock_| must be held and this pile-up
+  // must not be claimed by another call.
+  Status DeformAndAdvanceTimeLocked(Instant const& t);
+
+  // Waits until this pile-up is not claimed by a batch and claims it.  Release
+  // must be called once the batch is done with it.  |lock_| must be held.
+  void Claim();
+  void Release();
+
   // Flows the history authoritatively as far as possible up to |t|, advances
   // the histories of the parts and updates the degrees of freedom of the parts
   // if the pile-up is in the bubble.  After this call, the tail (of |*this|)
   // and of its parts have a (possibly ahistorical) final point exactly at |t|.
   Status AdvanceTime(Instant const& t);
 
+  // Integrates the |history_| with a fixed step as far as possible up to |t|,
+  // using the |fixed_instance_|, which is created if needed.
+  Status FlowHistoryWithFixedStep(Instant const& t);
+
+  // Forks the |psychohistory_| at the end of the |history_| and integrates it
+  // with an adaptive step up to |t|.
+  Status FlowPsychohistory(Instant const& t);
+
+  // Appends the points of the |history_| after |history_last| to the histories
+  // of the parts, and the points of the |psychohistory_| to their
+  // psychohistories.  Forgets the part of the |history_| before the
+  // |psychohistory_|.
+  void AppendToParts(DiscreteTrajectory<Barycentric>::Iterator history_last);
+
+  // Detaches this pile-up from its |history_batch_|, if any.  The batch becomes
+  // unusable for its other members.  If |continue_integration| is true and the
+  // batch has an instance, the |fixed_instance_| of this pile-up is split from
+  // it, so that the fixed-step integration of the |history_| continues where
+  // the batch left it instead of restarting.
+  void LeaveHistoryBatch(bool continue_integration);
+
   // Adjusts the degrees of freedom of all parts in this pile up based on the
   // degrees of freedom of the pile-up computed by |AdvanceTime| and on the
   // |NonRotatingPileUp| degrees of freedom of the parts, as set by
@@ -183,8 +238,37 @@ class PileUp {
   template<AppendToPartTrajectory append_to_part_trajectory>
   void AppendToPart(DiscreteTrajectory<Barycentric>::Iterator it) const;
 
+  // A set of pile-ups whose histories are integrated by a single fixed-step
+  // instance.
+  struct HistoryBatch {
+    // The number of pile-ups in the batch.
+    std::int64_t size = 0;
+    std::unique_ptr<typename Integrator<
+        Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
+        instance;
+    // Set when a member leaves the batch.  The |instance| must not be used
+    // anymore, as it may refer to the history of a pile-up that was destroyed.
+    std::atomic<bool> broken = false;
+
+    // Guards the fields below, which are used to split the |instance| once
+    // the batch is broken.
+    absl::Mutex lock;
+    // The pile-ups whose histories are integrated by the |instance|, in the
+    // order of its dimensions.  Set when the |instance| is created.  An entry
+    // is null once its pile-up has left the batch.
+    std::vector<PileUp*> members GUARDED_BY(lock);
+    // The instances split from |instance|, indexed like |members|.  Computed
+    // when the first member leaves the broken batch.
+    std::vector<std::unique_ptr<typename Integrator<
+        Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>>
+        split_instances GUARDED_BY(lock);
+  };
+
   // Wrapped in a |unique_ptr| to be moveable.
   not_null<std::unique_ptr<absl::Mutex>> lock_;
+  // True while a call to the static |DeformAndAdvanceTime| processes the batch
+  // that contains this pile-up.  Guarded by |lock_|.
+  bool claimed_ = false;
 
   std::list<not_null<Part*>> parts_;
   not_null<Ephemeris<Barycentric>*> ephemeris_;
@@ -228,6 +312,12 @@ class PileUp {
       Ephemeris<Barycentric>::NewtonianMotionEquation>::Instance>
       fixed_instance_;
 
+  // When not null, the |history_| of this pile-up is integrated together with
+  // those of other pile-ups.  Shared by the members of the batch.  The
+  // |fixed_instance_|, if any, is kept until the batch creates its instance,
+  // and is split from the instance of the batch when this pile-up leaves it.
+  std::shared_ptr<HistoryBatch> history_batch_;
+
   PartTo<RigidMotion<RigidPart, NonRotatingPileUp>> actual_part_rigid_motion_;
   PartTo<RigidMotion<RigidPart, Apparent>> apparent_part_rigid_motion_;
 
@@ -243,9 +333,9 @@ class PileUp {
 
 // A convenient data object to track a pile-up and the result of integrating it.
 struct PileUpFuture {
-  PileUpFuture(not_null<PileUp const*> pile_up, std::future<Status> future);
+  PileUpFuture(not_null<PileUp const*> pile_up, Task<Status> future);
   not_null<PileUp const*> pile_up;
-  std::future<Status> future;
+  Task<Status> future;
 };
 
 }  // namespace internal_pile_up
@@ -41,11 +41,13 @@ Planetarium::Planetarium(
     Parameters const& parameters,
     Perspective<Navigation, Camera> perspective,
     not_null<Ephemeris<Barycentric> const*> const ephemeris,
-    not_null<NavigationFrame const*> const plotting_frame)
+    not_null<NavigationFrame const*> const plotting_frame,
+    WorkStealingThreadPool* const thread_pool)
     : parameters_(parameters),
       perspective_(std::move(perspective)),
       ephemeris_(ephemeris),
-      plotting_frame_(plotting_frame) {}
+      plotting_frame_(plotting_frame),
+      thread_pool_(thread_pool) {}
 
 RP2Lines<Length, Camera> Planetarium::PlotMethod0(
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
@@ -156,8 +158,73 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     Instant const& last_time,
     Instant const& now,
     bool const reverse) const {
-  RP2Lines<Length, Camera> lines;
+  return PlotMethod2(ComputePlottableSpheres(now),
+                     ToPlottingFrameAtTime(reverse ? last_time : first_time),
+                     trajectory,
+                     first_time,
+                     last_time,
+                     reverse);
+}
+
+std::vector<RP2Lines<Length, Camera>> Planetarium::PlotMethod2(
+    std::vector<PlotMethod2Job> const& jobs,
+    Instant const& now) const {
+  std::vector<RP2Lines<Length, Camera>> lines(jobs.size());
+  if (jobs.empty()) {
+    return lines;
+  }
   auto const plottable_spheres = ComputePlottableSpheres(now);
+
+  // The plotting frame at the start of each job is computed in one batch, and
+  // passed directly to the plotting, bypassing the cache.
+  std::vector<Instant> start_times;
+  for (auto const& job : jobs) {
+    start_times.push_back(job.reverse ? job.last_time : job.first_time);
+  }
+  std::sort(start_times.begin(), start_times.end());
+  start_times.erase(std::unique(start_times.begin(), start_times.end()),
+                    start_times.end());
+  auto const to_plotting_frame_at_start_times =
+      plotting_frame_->ToThisFrameAtTimes(start_times);
+
+  auto const plot_job = [this,
+                         &jobs,
+                         &lines,
+                         &plottable_spheres,
+                         &start_times,
+                         &to_plotting_frame_at_start_times](
+                            std::int64_t const i) {
+    auto const& job = jobs[i];
+    auto const start_time_index =
+        std::lower_bound(start_times.begin(),
+                         start_times.end(),
+                         job.reverse ? job.last_time : job.first_time) -
+        start_times.begin();
+    lines[i] = PlotMethod2(plottable_spheres,
+                           to_plotting_frame_at_start_times[start_time_index],
+                           *job.trajectory,
+                           job.first_time,
+                           job.last_time,
+                           job.reverse);
+  };
+  if (thread_pool_ == nullptr) {
+    for (std::int64_t i = 0; i < jobs.size(); ++i) {
+      plot_job(i);
+    }
+  } else {
+    thread_pool_->ParallelFor(0, jobs.size(), plot_job);
+  }
+  return lines;
+}
+
+RP2Lines<Length, Camera> Planetarium::PlotMethod2(
+    ConeHierarchy<Navigation> const& plottable_spheres,
+    RigidMotion<Barycentric, Navigation> const& to_plotting_frame_at_start,
+    Trajectory<Barycentric> const& trajectory,
+    Instant const& first_time,
+    Instant const& last_time,
+    bool const reverse) const {
+  RP2Lines<Length, Camera> lines;
   double const tan²_angular_resolution =
       Pow<2>(parameters_.tan_angular_resolution_);
   auto const final_time = reverse ? first_time : last_time;
@@ -168,7 +235,7 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
     return lines;
   }
   RigidMotion<Barycentric, Navigation> to_plotting_frame_at_t =
-      plotting_frame_->ToThisFrameAtTime(previous_time);
+      to_plotting_frame_at_start;
   DegreesOfFreedom<Navigation> const initial_degrees_of_freedom =
       to_plotting_frame_at_t(
           trajectory.EvaluateDegreesOfFreedom(previous_time));
@@ -251,10 +318,10 @@ RP2Lines<Length, Camera> Planetarium::PlotMethod2(
   return lines;
 }
 
-std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
+ConeHierarchy<Navigation> Planetarium::ComputePlottableSpheres(
     Instant const& now) const {
   RigidMotion<Barycentric, Navigation> const rigid_motion_at_now =
-      plotting_frame_->ToThisFrameAtTime(now);
+      ToPlottingFrameAtTime(now);
   std::vector<Sphere<Navigation>> plottable_spheres;
 
   auto const& bodies = ephemeris_->bodies();
@@ -273,34 +340,39 @@ std::vector<Sphere<Navigation>> Planetarium::ComputePlottableSpheres(
       plottable_spheres.emplace_back(std::move(plottable_sphere));
     }
   }
-  return plottable_spheres;
+  return perspective_.ComputeConeHierarchy(std::move(plottable_spheres));
 }
 
 Segments<Navigation> Planetarium::ComputePlottableSegments(
-    const std::vector<Sphere<Navigation>>& plottable_spheres,
+    ConeHierarchy<Navigation> const& plottable_spheres,
     DiscreteTrajectory<Barycentric>::Iterator const& begin,
     DiscreteTrajectory<Barycentric>::Iterator const& end) const {
   Segments<Navigation> all_segments;
   if (begin == end) {
     return all_segments;
   }
-  auto it1 = begin;
-  Instant t1 = it1->time;
-  RigidMotion<Barycentric, Navigation> rigid_motion_at_t1 =
-      plotting_frame_->ToThisFrameAtTime(t1);
+
+  // Compute all the rigid motions at once.  They are not cached, as they are
+  // rarely reused.
+  std::vector<Instant> times;
+  for (auto it = begin; it != end; ++it) {
+    times.push_back(it->time);
+  }
+  std::vector<RigidMotion<Barycentric, Navigation>> const rigid_motions =
+      plotting_frame_->ToThisFrameAtTimes(times);
+
   Position<Navigation> p1 =
-      rigid_motion_at_t1(it1->degrees_of_freedom).position();
+      rigid_motions.front()(begin->degrees_of_freedom).position();
 
-  auto it2 = it1;
+  int i2 = 0;
+  auto it2 = begin;
   while (++it2 != end) {
     // Processing one segment of the trajectory.
-    Instant const t2 = it2->time;
+    ++i2;
 
     // Transform the degrees of freedom to the plotting frame.
-    RigidMotion<Barycentric, Navigation> const rigid_motion_at_t2 =
-        plotting_frame_->ToThisFrameAtTime(t2);
     Position<Navigation> const p2 =
-        rigid_motion_at_t2(it2->degrees_of_freedom).position();
+        rigid_motions[i2](it2->degrees_of_freedom).position();
 
     // Find the part of the segment that is behind the focal plane.  We don't
     // care about things that are in front of the focal plane.
@@ -317,15 +389,29 @@ Segments<Navigation> Planetarium::ComputePlottableSegments(
                 std::back_inserter(all_segments));
     }
 
-    it1 = it2;
-    t1 = t2;
-    rigid_motion_at_t1 = rigid_motion_at_t2;
     p1 = p2;
   }
 
   return all_segments;
 }
 
+RigidMotion<Barycentric, Navigation> Planetarium::ToPlottingFrameAtTime(
+    Instant const& t) const {
+  {
+    absl::ReaderMutexLock l(&to_plotting_frame_lock_);
+    auto const it = to_plotting_frame_.find(t);
+    if (it != to_plotting_frame_.end()) {
+      return it->second;
+    }
+  }
+  // Computed without holding the lock.  If another thread computes the same
+  // rigid motion concurrently, the results are identical.
+  auto const rigid_motion = plotting_frame_->ToThisFrameAtTime(t);
+  absl::MutexLock l(&to_plotting_frame_lock_);
+  to_plotting_frame_.emplace(t, rigid_motion);
+  return rigid_motion;
+}
+
 }  // namespace internal_planetarium
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -1,9 +1,13 @@
 ﻿
 #pragma once
 
+#include <map>
 #include <vector>
 
+#include "absl/synchronization/mutex.h"
 #include "base/not_null.hpp"
+#include "base/work_stealing_thread_pool.hpp"
+#include "geometry/cone_hierarchy.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/perspective.hpp"
@@ -21,6 +25,8 @@ namespace ksp_plugin {
 namespace internal_planetarium {
 
 using base::not_null;
+using base::WorkStealingThreadPool;
+using geometry::ConeHierarchy;
 using geometry::Displacement;
 using geometry::Instant;
 using geometry::OrthogonalMap;
@@ -60,12 +66,25 @@ class Planetarium {
     friend class Planetarium;
   };
 
+  // The arguments of a call to |PlotMethod2| on the |Trajectory| interface.
+  struct PlotMethod2Job final {
+    not_null<Trajectory<Barycentric> const*> trajectory;
+    Instant first_time;
+    Instant last_time;
+    bool reverse;
+  };
+
   // TODO(phl): All this Navigation is weird.  Should it be named Plotting?
   // In particular Navigation vs. NavigationFrame is a mess.
+  // If |thread_pool| is null, the batches of trajectories are plotted
+  // sequentially.
   Planetarium(Parameters const& parameters,
               Perspective<Navigation, Camera> perspective,
               not_null<Ephemeris<Barycentric> const*> ephemeris,
-              not_null<NavigationFrame const*> plotting_frame);
+              not_null<NavigationFrame const*> plotting_frame,
+              WorkStealingThreadPool* thread_pool = nullptr);
+
+  virtual ~Planetarium() = default;
 
   // A no-op method that just returns all the points in the trajectory defined
   // by |begin| and |end|.
@@ -100,23 +119,59 @@ class Planetarium {
       Instant const& now,
       bool reverse) const;
 
+  // Plots each of the |jobs| as above, in parallel on the pool given at
+  // construction, and returns the lines in the order of the |jobs|.  The
+  // plottable spheres are only computed once.  The result is the same as that
+  // of separate calls.
+  virtual std::vector<RP2Lines<Length, Camera>> PlotMethod2(
+      std::vector<PlotMethod2Job> const& jobs,
+      Instant const& now) const;
+
  private:
+  // The implementation of |PlotMethod2|, given the |plottable_spheres| at the
+  // current time and the rigid motion to the plotting frame at the time where
+  // the plotting starts, i.e., |last_time| if |reverse| and |first_time|
+  // otherwise.
+  RP2Lines<Length, Camera> PlotMethod2(
+      ConeHierarchy<Navigation> const& plottable_spheres,
+      RigidMotion<Barycentric, Navigation> const& to_plotting_frame_at_start,
+      Trajectory<Barycentric> const& trajectory,
+      Instant const& first_time,
+      Instant const& last_time,
+      bool reverse) const;
+
   // Computes the coordinates of the spheres that represent the |ephemeris_|
-  // bodies.  These coordinates are in the |plotting_frame_| at time |now|.
-  std::vector<Sphere<Navigation>> ComputePlottableSpheres(
-      Instant const& now) const;
+  // bodies.  These coordinates are in the |plotting_frame_| at time |now|.  The
+  // spheres are organized in a hierarchy of the cones under which they are seen
+  // from the camera, so that each segment is only tested against the spheres
+  // that may hide it.
+  ConeHierarchy<Navigation> ComputePlottableSpheres(Instant const& now) const;
 
   // Computes the segments of the trajectory defined by |begin| and |end| that
   // are not hidden by the |plottable_spheres|.
   Segments<Navigation> ComputePlottableSegments(
-      const std::vector<Sphere<Navigation>>& plottable_spheres,
+      ConeHierarchy<Navigation> const& plottable_spheres,
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
       DiscreteTrajectory<Barycentric>::Iterator const& end) const;
 
+  // Returns |plotting_frame_->ToThisFrameAtTime(t)|.  The result is cached:
+  // all the trajectories of a frame are plotted by the same planetarium, and
+  // they are all plotted relative to the bodies at the current time, and often
+  // start at the same time.  Only used for these times, the other rigid motions
+  // are computed directly.
+  RigidMotion<Barycentric, Navigation> ToPlottingFrameAtTime(
+      Instant const& t) const EXCLUDES(to_plotting_frame_lock_);
+
   Parameters const parameters_;
   Perspective<Navigation, Camera> const perspective_;
   not_null<Ephemeris<Barycentric> const*> const ephemeris_;
   not_null<NavigationFrame const*> const plotting_frame_;
+  // The pool used to plot multiple trajectories in parallel, not owned.
+  WorkStealingThreadPool* const thread_pool_;
+
+  mutable absl::Mutex to_plotting_frame_lock_;
+  mutable std::map<Instant, RigidMotion<Barycentric, Navigation>>
+      to_plotting_frame_ GUARDED_BY(to_plotting_frame_lock_);
 };
 
 }  // namespace internal_planetarium
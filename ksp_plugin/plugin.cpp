@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
 #include <filesystem>
 #include <fstream>
 #include <ios>
@@ -58,6 +59,8 @@ namespace principia {
 namespace ksp_plugin {
 namespace internal_plugin {
 
+using astronomy::InfiniteFuture;
+using astronomy::InfinitePast;
 using astronomy::KSP122;
 using astronomy::KSP191;
 using astronomy::KSPStabilizedSystemFingerprints;
@@ -75,6 +78,7 @@ using base::not_null;
 using base::OFStream;
 using base::SerializeAsBytes;
 using base::Status;
+using base::Task;
 using geometry::AffineMap;
 using geometry::AngularVelocity;
 using geometry::BarycentreCalculator;
@@ -94,8 +98,6 @@ using physics::BodyCentredBodyDirectionDynamicFrame;
 using physics::BodyCentredNonRotatingDynamicFrame;
 using physics::BodySurfaceDynamicFrame;
 using physics::BodySurfaceFrameField;
-using physics::ComputeApsides;
-using physics::ComputeNodes;
 using physics::CoordinateFrameField;
 using physics::DynamicFrame;
 using physics::Frenet;
@@ -115,10 +117,12 @@ using ::operator<<;
 Plugin::Plugin(std::string const& game_epoch,
                std::string const& solar_system_epoch,
                Angle const& planetarium_rotation)
-    : history_parameters_(DefaultHistoryParameters()),
-      psychohistory_parameters_(DefaultPsychohistoryParameters()),
+    : background_thread_pool_(
+          /*pool_size=*/std::max(1u, std::thread::hardware_concurrency() / 2)),
       vessel_thread_pool_(
           /*pool_size=*/2 * std::thread::hardware_concurrency()),
+      history_parameters_(DefaultHistoryParameters()),
+      psychohistory_parameters_(DefaultPsychohistoryParameters()),
       planetarium_rotation_(planetarium_rotation),
       game_epoch_(ParseTT(game_epoch)),
       current_time_(ParseTT(solar_system_epoch)) {
@@ -232,6 +236,7 @@ void Plugin::EndInitialization() {
                                      DefaultEphemerisAccuracyParameters()),
                                  ephemeris_fixed_step_parameters_.value_or(
                                      DefaultEphemerisFixedStepParameters()));
+  ephemeris_->SetThreadPool(&vessel_thread_pool_);
 
   // Construct the celestials using the bodies from the ephemeris.
   for (std::string const& name : solar_system.names()) {
@@ -386,6 +391,8 @@ void Plugin::InsertOrKeepVessel(GUID const& vessel_guid,
                                          vessel_name,
                                          parent,
                                          ephemeris_.get(),
+                                         &background_thread_pool_,
+                                         &vessel_thread_pool_,
                                          prediction_parameters));
   } else {
     inserted = false;
@@ -764,22 +771,28 @@ void Plugin::AdvanceTime(Instant const& t, Angle const& planetarium_rotation) {
 void Plugin::CatchUpLaggingVessels(VesselSet& collided_vessels) {
   CHECK(!initializing_);
 
-  // Start all the integrations in parallel.
-  std::vector<PileUpFuture> pile_up_futures;
-  for (auto* const pile_up : pile_ups_) {
-    pile_up_futures.emplace_back(
-        pile_up,
-        vessel_thread_pool_.Add([this, pile_up]() {
-          // Note that there cannot be contention in the following method as
-          // no two pile-ups are advanced at the same time.
-          return pile_up->DeformAndAdvanceTime(current_time_);
-        }));
+  // Start all the integrations in parallel.  The pile-ups whose histories can
+  // be integrated together are batched, so that the positions of the
+  // celestials are only evaluated once per step for each batch.
+  std::vector<std::vector<not_null<PileUp*>>> const batches =
+      PileUp::MakeBatches(pile_ups_);
+  std::vector<Task<std::vector<Status>>> batch_tasks;
+  for (auto const& batch : batches) {
+    batch_tasks.push_back(vessel_thread_pool_.Add([this, &batch]() {
+      // Note that there cannot be contention in the following method as
+      // no two pile-ups are advanced at the same time.
+      return PileUp::DeformAndAdvanceTime(
+          batch, current_time_, vessel_thread_pool_);
+    }));
   }
 
   // Wait for the integrations to finish and figure out which vessels collided
   // with a celestial.
-  for (auto& pile_up_future : pile_up_futures) {
-    WaitForVesselToCatchUp(pile_up_future, collided_vessels);
+  for (std::int64_t i = 0; i < batches.size(); ++i) {
+    std::vector<Status> const statuses = batch_tasks[i].Get();
+    for (std::int64_t j = 0; j < batches[i].size(); ++j) {
+      InsertCollidedVessels(*batches[i][j], statuses[j], collided_vessels);
+    }
   }
 
   // Update the vessels.
@@ -821,21 +834,8 @@ not_null<std::unique_ptr<PileUpFuture>> Plugin::CatchUpVessel(
 
 void Plugin::WaitForVesselToCatchUp(PileUpFuture& pile_up_future,
                                     VesselSet& collided_vessels) {
-  PileUp const* const pile_up = pile_up_future.pile_up;
-  auto& future = pile_up_future.future;
-  future.wait();
-  Status const status = future.get();
-  if (!status.ok()) {
-    for (not_null<Part*> const part : pile_up->parts()) {
-      not_null<Vessel*> const vessel =
-          FindOrDie(part_id_to_vessel_, part->part_id());
-      if (bool const inserted = collided_vessels.insert(vessel).second;
-          inserted) {
-        LOG(WARNING) << "Vessel " << vessel->ShortDebugString()
-                     << " collided with a celestial: " << status.ToString();
-      }
-    }
-  }
+  Status const status = pile_up_future.future.Get();
+  InsertCollidedVessels(*pile_up_future.pile_up, status, collided_vessels);
 }
 
 RelativeDegreesOfFreedom<AliceSun> Plugin::VesselFromParent(
@@ -890,9 +890,20 @@ void Plugin::SetPredictionAdaptiveStepParameters(
 
 void Plugin::UpdatePrediction(std::vector<GUID> const& vessel_guids) const {
   CHECK(!initializing_);
+  // The prognostications of the target vessel and of the first vessel (which
+  // is the active vessel) are computed before the others if the prognosticator
+  // threads are busy.
+  std::int64_t const target_vessel_priority = 2;
+  std::int64_t const active_vessel_priority = 1;
+  std::int64_t const predicted_vessel_priority = 0;
+
   std::set<not_null<Vessel*>> predicted_vessels;
   for (auto const& guid : vessel_guids) {
-    predicted_vessels.insert(FindOrDie(vessels_, guid).get());
+    not_null<Vessel*> const vessel = FindOrDie(vessels_, guid).get();
+    vessel->set_prognostication_priority(predicted_vessels.empty()
+                                             ? active_vessel_priority
+                                             : predicted_vessel_priority);
+    predicted_vessels.insert(vessel);
   }
   Vessel* target_vessel = nullptr;
 
@@ -901,6 +912,7 @@ void Plugin::UpdatePrediction(std::vector<GUID> const& vessel_guids) const {
   // targeting frame.
   if (renderer_->HasTargetVessel()) {
     target_vessel = &renderer_->GetTargetVessel();
+    target_vessel->set_prognostication_priority(target_vessel_priority);
     target_vessel->RefreshPrediction();
     for (auto const vessel : predicted_vessels) {
       vessel->RefreshPrediction(target_vessel->prediction().back().time);
@@ -910,9 +922,12 @@ void Plugin::UpdatePrediction(std::vector<GUID> const& vessel_guids) const {
       vessel->RefreshPrediction();
     }
   }
+  // The vessels that are not predicted anymore lose the priority that they may
+  // have had when they were the active or target vessel.
   for (auto const& [guid, vessel] : vessels_) {
     if (!Contains(predicted_vessels, vessel.get()) &&
         vessel.get() != target_vessel) {
+      vessel->set_prognostication_priority(predicted_vessel_priority);
       vessel->StopPrognosticator();
     }
   }
@@ -939,14 +954,14 @@ void Plugin::ComputeAndRenderApsides(
     int const max_points,
     std::unique_ptr<DiscreteTrajectory<World>>& apoapsides,
     std::unique_ptr<DiscreteTrajectory<World>>& periapsides) const {
+  Trajectory<Barycentric> const& reference =
+      FindOrDie(celestials_, celestial_index)->trajectory();
+  auto& index = FindOrEmplaceEventIndex(
+      apsides_indices_, std::pair(end.trajectory(), &reference));
+  index.Update(reference, begin, end);
   DiscreteTrajectory<Barycentric> apoapsides_trajectory;
   DiscreteTrajectory<Barycentric> periapsides_trajectory;
-  ComputeApsides(FindOrDie(celestials_, celestial_index)->trajectory(),
-                 begin,
-                 end,
-                 max_points,
-                 apoapsides_trajectory,
-                 periapsides_trajectory);
+  index.Get(max_points, apoapsides_trajectory, periapsides_trajectory);
   apoapsides = renderer_->RenderBarycentricTrajectoryInWorld(
                    current_time_,
                    apoapsides_trajectory.begin(),
@@ -969,14 +984,14 @@ void Plugin::ComputeAndRenderClosestApproaches(
     std::unique_ptr<DiscreteTrajectory<World>>& closest_approaches) const {
   CHECK(renderer_->HasTargetVessel());
 
+  Trajectory<Barycentric> const& reference =
+      renderer_->GetTargetVessel().prediction();
+  auto& index = FindOrEmplaceEventIndex(
+      apsides_indices_, std::pair(end.trajectory(), &reference));
+  index.Update(reference, begin, end);
   DiscreteTrajectory<Barycentric> apoapsides_trajectory;
   DiscreteTrajectory<Barycentric> periapsides_trajectory;
-  ComputeApsides(renderer_->GetTargetVessel().prediction(),
-                 begin,
-                 end,
-                 max_points,
-                 apoapsides_trajectory,
-                 periapsides_trajectory);
+  index.Get(max_points, apoapsides_trajectory, periapsides_trajectory);
   closest_approaches =
       renderer_->RenderBarycentricTrajectoryInWorld(
           current_time_,
@@ -993,9 +1008,6 @@ void Plugin::ComputeAndRenderNodes(
     int const max_points,
     std::unique_ptr<DiscreteTrajectory<World>>& ascending,
     std::unique_ptr<DiscreteTrajectory<World>>& descending) const {
-  auto const trajectory_in_plotting =
-      renderer_->RenderBarycentricTrajectoryInPlotting(begin, end);
-
   auto const* const cast_plotting_frame = dynamic_cast<
       BodyCentredNonRotatingDynamicFrame<Barycentric, Navigation> const*>(
       &*renderer_->GetPlottingFrame());
@@ -1013,16 +1025,33 @@ void Plugin::ComputeAndRenderNodes(
     return (dof.position() - Navigation::origin).Norm() < threshold;
   };
 
+  // As in |Renderer::RenderBarycentricTrajectoryInPlotting|, the points that
+  // are not covered by the prediction of the target vessel, if any, cannot be
+  // plotted.
+  Instant t_min = InfinitePast;
+  Instant t_max = InfiniteFuture;
+  if (renderer_->HasTargetVessel()) {
+    auto const& prediction = renderer_->GetTargetVessel().prediction();
+    t_min = prediction.t_min();
+    t_max = prediction.t_max();
+  }
+
+  // The so-called North is orthogonal to the plane of the trajectory.
+  auto& index = FindOrEmplaceEventIndex(nodes_indices_,
+                                        end.trajectory(),
+                                        Vector<double, Navigation>({0, 0, 1}));
+  index.Update(
+      begin,
+      end,
+      [this](Instant const& time,
+             DegreesOfFreedom<Barycentric> const& degrees_of_freedom) {
+        return renderer_->BarycentricToPlotting(time)(degrees_of_freedom);
+      },
+      t_min,
+      t_max);
   DiscreteTrajectory<Navigation> ascending_trajectory;
   DiscreteTrajectory<Navigation> descending_trajectory;
-  // The so-called North is orthogonal to the plane of the trajectory.
-  ComputeNodes(trajectory_in_plotting->begin(),
-               trajectory_in_plotting->end(),
-               Vector<double, Navigation>({0, 0, 1}),
-               max_points,
-               ascending_trajectory,
-               descending_trajectory,
-               show_node);
+  index.Get(max_points, ascending_trajectory, descending_trajectory, show_node);
 
   ascending = renderer_->RenderPlottingTrajectoryInWorld(
                   current_time_,
@@ -1038,6 +1067,55 @@ void Plugin::ComputeAndRenderNodes(
                    PlanetariumRotation());
 }
 
+std::vector<VesselConjunction> Plugin::ComputeConjunctions(
+    Length const& threshold,
+    Time const& horizon) const {
+  // The slices should be short compared to an orbital period, so that the
+  // bounding boxes are small, but there is a box per slice and per vessel, so
+  // their number must be bounded for long horizons or large fleets.
+  constexpr Time min_slice_duration = 1 * Minute;
+  constexpr std::int64_t max_bounding_boxes = 1 << 18;
+
+  // Vessels whose prediction ends before the current time don't have any
+  // conjunction in the future, so they are not considered at all.  The
+  // conjunctions cannot extend beyond the end of the longest prediction.
+  std::vector<GUID> guids;
+  std::vector<not_null<DiscreteTrajectory<Barycentric> const*>> predictions;
+  Instant t_max = current_time_;
+  for (auto const& [guid, vessel] : vessels_) {
+    auto const& prediction = vessel->prediction();
+    if (prediction.Empty() || prediction.t_max() < current_time_) {
+      continue;
+    }
+    guids.push_back(guid);
+    predictions.push_back(&prediction);
+    t_max = std::max(t_max, prediction.t_max());
+  }
+  if (predictions.size() < 2) {
+    return {};
+  }
+  t_max = std::min(t_max, current_time_ + horizon);
+  std::int64_t const max_slices = std::max<std::int64_t>(
+      1, max_bounding_boxes / static_cast<std::int64_t>(predictions.size()));
+  Time const slice_duration =
+      std::max(min_slice_duration, (t_max - current_time_) / max_slices);
+
+  std::vector<VesselConjunction> vessel_conjunctions;
+  for (auto const& conjunction :
+       physics::ComputeConjunctions(predictions,
+                                    current_time_,
+                                    t_max,
+                                    threshold,
+                                    slice_duration,
+                                    &vessel_thread_pool_)) {
+    vessel_conjunctions.push_back({guids[conjunction.first],
+                                   guids[conjunction.second],
+                                   conjunction.time,
+                                   conjunction.distance});
+  }
+  return vessel_conjunctions;
+}
+
 bool Plugin::HasCelestial(Index const index) const {
   return Contains(celestials_, index);
 }
@@ -1070,7 +1148,8 @@ not_null<std::unique_ptr<Planetarium>> Plugin::NewPlanetarium(
   return make_not_null_unique<Planetarium>(parameters,
                                            perspective,
                                            ephemeris_.get(),
-                                           renderer_->GetPlottingFrame());
+                                           renderer_->GetPlottingFrame(),
+                                           &vessel_thread_pool_);
 }
 
 not_null<std::unique_ptr<NavigationFrame>>
@@ -1401,8 +1480,11 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
 
   // The ephemeris constructed here is *not* prolonged and needs to be
   // explicitly prolonged to cover all the instants that we care about.
+  // The past of the ephemeris is reanimated in the background.
   plugin->ephemeris_ =
-      Ephemeris<Barycentric>::ReadFromMessage(message.ephemeris());
+      Ephemeris<Barycentric>::ReadFromMessage(message.ephemeris(),
+                                              &plugin->background_thread_pool_);
+  plugin->ephemeris_->SetThreadPool(&plugin->vessel_thread_pool_);
   plugin->ephemeris_->Prolong(plugin->game_epoch_);
   plugin->ephemeris_->Prolong(plugin->current_time_);
 
@@ -1411,18 +1493,33 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
                              plugin->celestials_,
                              plugin->name_to_index_);
 
-  for (auto const& vessel_message : message.vessel()) {
-    not_null<Celestial const*> const parent =
-        FindOrDie(plugin->celestials_, vessel_message.parent_index()).get();
-    not_null<std::unique_ptr<Vessel>> vessel = Vessel::ReadFromMessage(
-        vessel_message.vessel(),
-        parent,
-        plugin->ephemeris_.get(),
-        [&part_id_to_vessel = plugin->part_id_to_vessel_](
-            PartId const part_id) {
-          CHECK_NE(part_id_to_vessel.erase(part_id), 0) << part_id;
-        });
+  // The vessels are deserialized in parallel, since most of the time is spent
+  // decompressing their trajectories and they only share the ephemeris, which
+  // is thread-safe.  The cross-references between the vessels, the parts and
+  // the pile-ups are established sequentially below.
+  std::vector<std::unique_ptr<Vessel>> vessels(message.vessel_size());
+  plugin->vessel_thread_pool_.ParallelFor(
+      0,
+      message.vessel_size(),
+      [&message, plugin = plugin.get(), &vessels](std::int64_t const i) {
+        auto const& vessel_message = message.vessel(i);
+        not_null<Celestial const*> const parent =
+            FindOrDie(plugin->celestials_, vessel_message.parent_index()).get();
+        vessels[i] = Vessel::ReadFromMessage(
+            vessel_message.vessel(),
+            parent,
+            plugin->ephemeris_.get(),
+            &plugin->background_thread_pool_,
+            &plugin->vessel_thread_pool_,
+            [&part_id_to_vessel = plugin->part_id_to_vessel_](
+                PartId const part_id) {
+              CHECK_NE(part_id_to_vessel.erase(part_id), 0) << part_id;
+            });
+      });
 
+  for (int i = 0; i < message.vessel_size(); ++i) {
+    auto const& vessel_message = message.vessel(i);
+    not_null<std::unique_ptr<Vessel>> vessel = std::move(vessels[i]);
     if (vessel_message.loaded()) {
       plugin->loaded_vessels_.insert(vessel.get());
     }
@@ -1439,6 +1536,22 @@ not_null<std::unique_ptr<Plugin>> Plugin::ReadFromMessage(
     plugin->part_id_to_vessel_.emplace(part_id, vessel.get());
   }
 
+  // The histories of the vessels may be rendered in frames that need the
+  // ephemeris at their times, so that part of the past must be available.  The
+  // older past continues to be reanimated in the background.
+  Instant earliest_history_time = plugin->current_time_;
+  for (auto const& [_, vessel] : plugin->vessels_) {
+    if (!vessel->psychohistory().Empty()) {
+      earliest_history_time =
+          std::min(earliest_history_time, vessel->psychohistory().front().time);
+    }
+  }
+  Status const reanimation_status =
+      plugin->ephemeris_->AwaitReanimation(earliest_history_time);
+  LOG_IF(ERROR, !reanimation_status.ok())
+      << "Unable to reanimate the ephemeris back to " << earliest_history_time
+      << ": " << reanimation_status;
+
   plugin->sun_ = FindOrDie(plugin->celestials_, message.sun_index()).get();
   plugin->main_body_ = plugin->sun_->body();
   plugin->UpdatePlanetariumRotation();
@@ -1509,10 +1622,12 @@ Plugin::Plugin(
     Ephemeris<Barycentric>::FixedStepParameters history_parameters,
     Ephemeris<Barycentric>::AdaptiveStepParameters
         psychohistory_parameters)
-    : history_parameters_(std::move(history_parameters)),
-      psychohistory_parameters_(std::move(psychohistory_parameters)),
+    : background_thread_pool_(
+          /*pool_size=*/std::max(1u, std::thread::hardware_concurrency() / 2)),
       vessel_thread_pool_(
-          /*pool_size=*/2 * std::thread::hardware_concurrency()) {}
+          /*pool_size=*/2 * std::thread::hardware_concurrency()),
+      history_parameters_(std::move(history_parameters)),
+      psychohistory_parameters_(std::move(psychohistory_parameters)) {}
 
 void Plugin::InitializeIndices(std::string const& name,
                                Index const celestial_index,
@@ -1558,6 +1673,20 @@ Velocity<World> Plugin::VesselVelocity(
       plotting_frame_degrees_of_freedom.velocity());
 }
 
+template<typename Indices, typename... Args>
+typename Indices::mapped_type& Plugin::FindOrEmplaceEventIndex(
+    Indices& indices,
+    typename Indices::key_type const& key,
+    Args&&... args) {
+  // There are normally only a handful of trajectories whose events are
+  // displayed, but the keys of the trajectories that were deleted accumulate.
+  constexpr int max_event_indices = 16;
+  if (indices.size() >= max_event_indices && !Contains(indices, key)) {
+    indices.clear();
+  }
+  return indices.try_emplace(key, std::forward<Args>(args)...).first->second;
+}
+
 template<typename T>
 void Plugin::ReadCelestialsFromMessages(
     Ephemeris<Barycentric> const& ephemeris,
@@ -1615,6 +1744,22 @@ bool Plugin::is_loaded(not_null<Vessel*> vessel) const {
   return Contains(loaded_vessels_, vessel);
 }
 
+void Plugin::InsertCollidedVessels(PileUp const& pile_up,
+                                   Status const& status,
+                                   VesselSet& collided_vessels) const {
+  if (!status.ok()) {
+    for (not_null<Part*> const part : pile_up.parts()) {
+      not_null<Vessel*> const vessel =
+          FindOrDie(part_id_to_vessel_, part->part_id());
+      if (bool const inserted = collided_vessels.insert(vessel).second;
+          inserted) {
+        LOG(WARNING) << "Vessel " << vessel->ShortDebugString()
+                     << " collided with a celestial: " << status.ToString();
+      }
+    }
+  }
+}
+
 }  // namespace internal_plugin
 }  // namespace ksp_plugin
 }  // namespace principia
@@ -1,7 +1,6 @@
 ﻿
 #pragma once
 
-#include <future>
 #include <limits>
 #include <list>
 #include <map>
@@ -14,7 +13,8 @@
 
 #include "base/monostable.hpp"
 #include "base/status.hpp"
-#include "base/thread_pool.hpp"
+#include "base/stoppable_thread_pool.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "geometry/affine_map.hpp"
 #include "geometry/grassmann.hpp"
 #include "geometry/named_quantities.hpp"
@@ -27,7 +27,9 @@
 #include "ksp_plugin/renderer.hpp"
 #include "ksp_plugin/vessel.hpp"
 #include "integrators/ordinary_differential_equations.hpp"
+#include "physics/apsides.hpp"
 #include "physics/body.hpp"
+#include "physics/conjunctions.hpp"
 #include "physics/degrees_of_freedom.hpp"
 #include "physics/discrete_trajectory.hpp"
 #include "physics/dynamic_frame.hpp"
@@ -49,8 +51,9 @@ namespace internal_plugin {
 
 using base::not_null;
 using base::Status;
+using base::StoppableThreadPool;
 using base::Subset;
-using base::ThreadPool;
+using base::WorkStealingThreadPool;
 using geometry::AffineMap;
 using geometry::AngularVelocity;
 using geometry::Bivector;
@@ -66,6 +69,7 @@ using geometry::Vector;
 using geometry::Velocity;
 using integrators::FixedStepSizeIntegrator;
 using integrators::AdaptiveStepSizeIntegrator;
+using physics::ApsidesIndex;
 using physics::Body;
 using physics::DegreesOfFreedom;
 using physics::DiscreteTrajectory;
@@ -75,7 +79,9 @@ using physics::FrameField;
 using physics::Frenet;
 using physics::HierarchicalSystem;
 using physics::MassiveBody;
+using physics::NodesIndex;
 using physics::RelativeDegreesOfFreedom;
+using physics::Trajectory;
 using physics::RigidMotion;
 using physics::RotatingBody;
 using quantities::Angle;
@@ -93,6 +99,14 @@ using quantities::si::Second;
 // |b.flightGlobalsIndex| in C#. We use this as a key in an |std::map|.
 using Index = int;
 
+// A conjunction between the predictions of two vessels.
+struct VesselConjunction {
+  GUID first_vessel;
+  GUID second_vessel;
+  Instant time;
+  Length distance;
+};
+
 class Plugin {
  public:
   Plugin() = delete;
@@ -340,7 +354,9 @@ class Plugin {
                                 Mass const& initial_mass) const;
 
   // Computes the apsides of the trajectory defined by |begin| and |end| with
-  // respect to the celestial with index |celestial_index|.
+  // respect to the celestial with index |celestial_index|.  This function and
+  // the next two are incremental: they only process the points of the
+  // trajectory that changed since the last call for the same trajectory.
   virtual void ComputeAndRenderApsides(
       Index celestial_index,
       DiscreteTrajectory<Barycentric>::Iterator const& begin,
@@ -369,6 +385,13 @@ class Plugin {
       std::unique_ptr<DiscreteTrajectory<World>>& ascending,
       std::unique_ptr<DiscreteTrajectory<World>>& descending) const;
 
+  // Returns the conjunctions closer than |threshold| between the predictions
+  // of all pairs of vessels over [current_time, current_time + |horizon|],
+  // ordered by time.
+  virtual std::vector<VesselConjunction> ComputeConjunctions(
+      Length const& threshold,
+      Time const& horizon) const;
+
   virtual bool HasCelestial(Index index) const;
   virtual Celestial const& GetCelestial(Index index) const;
 
@@ -464,6 +487,14 @@ class Plugin {
       Instant const& time,
       DegreesOfFreedom<Barycentric> const& degrees_of_freedom) const;
 
+  // Returns the entry of |indices| for |key|, constructing it from |args| if
+  // it doesn't exist.  |indices| is cleared if it grows too large.
+  template<typename Indices, typename... Args>
+  static typename Indices::mapped_type& FindOrEmplaceEventIndex(
+      Indices& indices,
+      typename Indices::key_type const& key,
+      Args&&... args);
+
   // Fill |celestials| using the |index| and |parent_index| fields found in
   // |celestial_messages|.
   template<typename T>
@@ -484,6 +515,12 @@ class Plugin {
   // Whether |loaded_vessels_| contains |vessel|.
   bool is_loaded(not_null<Vessel*> vessel) const;
 
+  // If |status| indicates that the integration of |pile_up| failed, inserts
+  // the vessels of |pile_up| into |collided_vessels|.
+  void InsertCollidedVessels(PileUp const& pile_up,
+                             Status const& status,
+                             VesselSet& collided_vessels) const;
+
   // Initialization objects.
   base::Monostable initializing_;
   serialization::GravityModel gravity_model_;
@@ -501,12 +538,25 @@ class Plugin {
   std::optional<Ephemeris<Barycentric>::FixedStepParameters>
       ephemeris_fixed_step_parameters_;
 
+  // The pool for the long-running background computations: the
+  // prognostications of the vessels and the reanimation of the ephemeris.
+  // Declared before |vessels_| and |ephemeris_| so that it outlives them.
+  StoppableThreadPool background_thread_pool_;
+
   GUIDToOwnedVessel vessels_;
   // For each part, the vessel that this part belongs to. The part is guaranteed
   // to be in the parts() map of the vessel, and owned by it.
   std::map<PartId, not_null<Vessel*>> part_id_to_vessel_;
   IndexToOwnedCelestial celestials_;
 
+  // The thread pool for advancing vessels, for computing the conjunctions of
+  // their predictions, for the orbit analyses of the vessels and of their
+  // flight plans, and for plotting the trajectories in the planetaria.  The
+  // ephemeris also uses it to compute the effects of the geopotentials, so it
+  // is declared before |ephemeris_|.  Mutable because the conjunctions are
+  // computed, and the planetaria created, by const functions.
+  mutable WorkStealingThreadPool vessel_thread_pool_;
+
   // Not null after initialization.
   std::unique_ptr<Ephemeris<Barycentric>> ephemeris_;
 
@@ -514,9 +564,6 @@ class Plugin {
   Ephemeris<Barycentric>::FixedStepParameters history_parameters_;
   Ephemeris<Barycentric>::AdaptiveStepParameters psychohistory_parameters_;
 
-  // The thread pool for advancing vessels.
-  ThreadPool<Status> vessel_thread_pool_;
-
   Angle planetarium_rotation_;
   std::optional<Rotation<Barycentric, AliceSun>> cached_planetarium_rotation_;
   // The game epoch in real time.
@@ -549,6 +596,17 @@ class Plugin {
   std::map<GUID, Ephemeris<Barycentric>::AdaptiveStepParameters>
   zombie_prediction_adaptive_step_parameters_;
 
+  // The indices used by |ComputeAndRenderApsides|,
+  // |ComputeAndRenderClosestApproaches| and |ComputeAndRenderNodes|, keyed by
+  // the trajectory being analysed (and for the apsides, by the reference
+  // trajectory).  The keys may dangle: an index detects when the points it
+  // processed have changed, so reusing an address is harmless.
+  mutable std::map<std::pair<DiscreteTrajectory<Barycentric> const*,
+                             Trajectory<Barycentric> const*>,
+                   ApsidesIndex<Barycentric>> apsides_indices_;
+  mutable std::map<DiscreteTrajectory<Barycentric> const*,
+                   NodesIndex<Barycentric, Navigation>> nodes_indices_;
+
   friend class NavballFrameField;
   friend class TestablePlugin;
 };
@@ -22,9 +22,7 @@ using astronomy::InfiniteFuture;
 using base::Contains;
 using base::Error;
 using base::FindOrDie;
-using base::jthread;
 using base::make_not_null_unique;
-using base::MakeStoppableThread;
 using geometry::BarycentreCalculator;
 using geometry::Position;
 using quantities::IsFinite;
@@ -43,13 +41,16 @@ bool operator!=(Vessel::PrognosticatorParameters const& left,
          left.adaptive_step_parameters.length_integration_tolerance() !=
              right.adaptive_step_parameters.length_integration_tolerance() ||
          left.adaptive_step_parameters.speed_integration_tolerance() !=
-             right.adaptive_step_parameters.speed_integration_tolerance();
+             right.adaptive_step_parameters.speed_integration_tolerance() ||
+         left.prolongs_prediction != right.prolongs_prediction;
 }
 
 Vessel::Vessel(GUID guid,
                std::string name,
                not_null<Celestial const*> const parent,
                not_null<Ephemeris<Barycentric>*> const ephemeris,
+               not_null<StoppableThreadPool*> const prognosticator_pool,
+               WorkStealingThreadPool* const analysis_thread_pool,
                Ephemeris<Barycentric>::AdaptiveStepParameters
                    prediction_adaptive_step_parameters)
     : guid_(std::move(guid)),
@@ -59,6 +60,8 @@ Vessel::Vessel(GUID guid,
           std::move(prediction_adaptive_step_parameters)),
       parent_(parent),
       ephemeris_(ephemeris),
+      prognosticator_pool_(prognosticator_pool),
+      analysis_thread_pool_(analysis_thread_pool),
       history_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {
   // Can't create the |psychohistory_| and |prediction_| here because |history_|
   // is empty;
@@ -197,6 +200,15 @@ DiscreteTrajectory<Barycentric> const& Vessel::prediction() const {
 void Vessel::set_prediction_adaptive_step_parameters(
     Ephemeris<Barycentric>::AdaptiveStepParameters const&
         prediction_adaptive_step_parameters) {
+  if (&prediction_adaptive_step_parameters.integrator() !=
+          &prediction_adaptive_step_parameters_.integrator() ||
+      prediction_adaptive_step_parameters.length_integration_tolerance() !=
+          prediction_adaptive_step_parameters_
+              .length_integration_tolerance() ||
+      prediction_adaptive_step_parameters.speed_integration_tolerance() !=
+          prediction_adaptive_step_parameters_.speed_integration_tolerance()) {
+    prediction_is_stale_ = true;
+  }
   prediction_adaptive_step_parameters_ = prediction_adaptive_step_parameters;
   absl::MutexLock l(&prognosticator_lock_);
   if (prognosticator_parameters_) {
@@ -246,12 +258,11 @@ void Vessel::AdvanceTime() {
   AppendToVesselTrajectory(&Part::psychohistory_begin,
                            &Part::psychohistory_end,
                            *psychohistory_);
+  AttachPrediction(std::move(prediction));
   {
     absl::MutexLock l(&prognosticator_lock_);
-    if (prognostication_ == nullptr) {
-      AttachPrediction(std::move(prediction));
-    } else {
-      AttachPrediction(std::move(prognostication_));
+    if (prognostication_ != nullptr) {
+      AttachPrognostication();
     }
   }
 
@@ -275,7 +286,8 @@ void Vessel::CreateFlightPlan(
       final_time,
       ephemeris_,
       flight_plan_adaptive_step_parameters,
-      flight_plan_generalized_adaptive_step_parameters);
+      flight_plan_generalized_adaptive_step_parameters,
+      analysis_thread_pool_);
 }
 
 void Vessel::DeleteFlightPlan() {
@@ -329,24 +341,53 @@ void Vessel::RefreshPrediction() {
   // Note that we know that |RefreshPrediction| is called on the main thread,
   // therefore the ephemeris currently covers the last time of the
   // psychohistory.  Were this to change, this code might have to change.
-  prognosticator_parameters_ =
-      PrognosticatorParameters{Ephemeris<Barycentric>::Guard(ephemeris_),
-                               psychohistory_->back().time,
-                               psychohistory_->back().degrees_of_freedom,
-                               prediction_adaptive_step_parameters_};
-  if (synchronous_) {
+  if (prediction_is_prolongable_ && !prediction_is_stale_) {
+    // The vessel is coasting along its prediction, so we only need to
+    // integrate enough steps to give it its normal length.
+    auto adaptive_step_parameters = prediction_adaptive_step_parameters_;
+    adaptive_step_parameters.set_max_steps(
+        adaptive_step_parameters.max_steps() - prediction_->SizeAfterFork());
+    if (adaptive_step_parameters.max_steps() <= 0) {
+      // The prediction is long enough, and it will be shortened by the next
+      // calls to |AdvanceTime|.  Drop any pending parameters, they would
+      // recompute it from scratch.
+      prognosticator_parameters_.reset();
+    } else {
+      prognosticator_parameters_ =
+          PrognosticatorParameters{Ephemeris<Barycentric>::Guard(ephemeris_),
+                                   prediction_->back().time,
+                                   prediction_->back().degrees_of_freedom,
+                                   adaptive_step_parameters,
+                                   /*prolongs_prediction=*/true};
+    }
+  } else {
+    prognosticator_parameters_ =
+        PrognosticatorParameters{Ephemeris<Barycentric>::Guard(ephemeris_),
+                                 psychohistory_->back().time,
+                                 psychohistory_->back().degrees_of_freedom,
+                                 prediction_adaptive_step_parameters_,
+                                 /*prolongs_prediction=*/false};
+  }
+  if (!prognosticator_parameters_) {
+    // Nothing to compute.
+  } else if (synchronous_) {
     std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication;
     std::optional<PrognosticatorParameters> prognosticator_parameters;
     std::swap(prognosticator_parameters, prognosticator_parameters_);
+    bool const prolongs_prediction =
+        prognosticator_parameters->prolongs_prediction;
     Status const status =
         FlowPrognostication(std::move(*prognosticator_parameters),
                             prognostication);
-    SwapPrognostication(prognostication, status);
+    SwapPrognostication(prognostication, prolongs_prediction, status);
   } else {
-    StartPrognosticatorIfNeeded();
+    prognostication_scheduled_ = true;
+    prognosticator_pool_->Schedule(this,
+                                   prognostication_priority_,
+                                   [this]() { FlowPendingPrognostication(); });
   }
   if (prognostication_ != nullptr) {
-    AttachPrediction(std::move(prognostication_));
+    AttachPrognostication();
   }
 }
 
@@ -356,7 +397,14 @@ void Vessel::RefreshPrediction(Instant const& time) {
 }
 
 void Vessel::StopPrognosticator() {
-  prognosticator_ = jthread();
+  // Most vessels are not predicted, don't lock the pool for them.
+  if (prognostication_scheduled_.exchange(false)) {
+    prognosticator_pool_->Cancel(this);
+  }
+}
+
+void Vessel::set_prognostication_priority(std::int64_t const priority) {
+  prognostication_priority_ = priority;
 }
 
 std::string Vessel::ShortDebugString() const {
@@ -395,6 +443,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
     serialization::Vessel const& message,
     not_null<Celestial const*> const parent,
     not_null<Ephemeris<Barycentric>*> const ephemeris,
+    not_null<StoppableThreadPool*> const prognosticator_pool,
+    WorkStealingThreadPool* const analysis_thread_pool,
     std::function<void(PartId)> const& deletion_callback) {
   bool const is_pre_cesàro = message.has_psychohistory_is_authoritative();
   bool const is_pre_chasles = message.has_prediction();
@@ -407,6 +457,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
       message.name(),
       parent,
       ephemeris,
+      prognosticator_pool,
+      analysis_thread_pool,
       Ephemeris<Barycentric>::AdaptiveStepParameters::ReadFromMessage(
           message.prediction_adaptive_step_parameters()));
   for (auto const& serialized_part : message.parts()) {
@@ -466,7 +518,8 @@ not_null<std::unique_ptr<Vessel>> Vessel::ReadFromMessage(
 
   if (message.has_flight_plan()) {
     vessel->flight_plan_ = FlightPlan::ReadFromMessage(message.flight_plan(),
-                                                       ephemeris);
+                                                       ephemeris,
+                                                       analysis_thread_pool);
   }
   return vessel;
 }
@@ -489,7 +542,8 @@ void Vessel::RequestOrbitAnalysis(Time const& mission_duration) {
     // and given that we know many things about our trajectory in the analyser,
     // perhaps we should pick something appropriate automatically instead.  The
     // default will do in the meantime.
-    orbit_analyser_.emplace(ephemeris_, DefaultHistoryParameters());
+    orbit_analyser_.emplace(
+        ephemeris_, DefaultHistoryParameters(), analysis_thread_pool_);
   }
   if (orbit_analyser_->last_parameters().has_value() &&
       orbit_analyser_->last_parameters()->mission_duration !=
@@ -536,46 +590,32 @@ Vessel::Vessel()
       prediction_adaptive_step_parameters_(DefaultPredictionParameters()),
       parent_(testing_utilities::make_not_null<Celestial const*>()),
       ephemeris_(testing_utilities::make_not_null<Ephemeris<Barycentric>*>()),
+      prognosticator_pool_(
+          testing_utilities::make_not_null<StoppableThreadPool*>()),
       history_(make_not_null_unique<DiscreteTrajectory<Barycentric>>()) {}
 
-void Vessel::StartPrognosticatorIfNeeded() {
-  prognosticator_lock_.AssertHeld();
-  if (!prognosticator_.joinable()) {
-    prognosticator_ = MakeStoppableThread(
-        std::bind(&Vessel::RepeatedlyFlowPrognostication, this));
-  }
-}
-
-Status Vessel::RepeatedlyFlowPrognostication() {
-  for (std::chrono::steady_clock::time_point wakeup_time;;
-       std::this_thread::sleep_until(wakeup_time)) {
-    // No point in going faster than 50 Hz.
-    wakeup_time =
-        std::chrono::steady_clock::now() + std::chrono::milliseconds(20);
-    RETURN_IF_STOPPED;
-
-    std::optional<PrognosticatorParameters> prognosticator_parameters;
-    {
-      absl::MutexLock l(&prognosticator_lock_);
-      if (!prognosticator_parameters_) {
-        // No parameters, let's wait for them to appear.
-        continue;
-      }
-      std::swap(prognosticator_parameters, prognosticator_parameters_);
+void Vessel::FlowPendingPrognostication() {
+  std::optional<PrognosticatorParameters> prognosticator_parameters;
+  {
+    absl::MutexLock l(&prognosticator_lock_);
+    if (!prognosticator_parameters_) {
+      // The parameters were picked by a previous prognostication, or they
+      // were consumed synchronously.
+      return;
     }
-    RETURN_IF_STOPPED;
+    std::swap(prognosticator_parameters, prognosticator_parameters_);
+  }
 
-    std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication;
-    Status const status =
-        FlowPrognostication(std::move(*prognosticator_parameters),
-                            prognostication);
-    RETURN_IF_STOPPED;
-    {
-      absl::MutexLock l(&prognosticator_lock_);
-      SwapPrognostication(prognostication, status);
-    }
+  bool const prolongs_prediction =
+      prognosticator_parameters->prolongs_prediction;
+  std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication;
+  Status const status =
+      FlowPrognostication(std::move(*prognosticator_parameters),
+                          prognostication);
+  {
+    absl::MutexLock l(&prognosticator_lock_);
+    SwapPrognostication(prognostication, prolongs_prediction, status);
   }
-  return Status::OK;
 }
 
 Status Vessel::FlowPrognostication(
@@ -588,12 +628,16 @@ Status Vessel::FlowPrognostication(
       prognosticator_parameters.first_time,
       prognosticator_parameters.first_degrees_of_freedom);
   Status status;
-  status = ephemeris_->FlowWithAdaptiveStep(
-      prognostication.get(),
-      Ephemeris<Barycentric>::NoIntrinsicAcceleration,
-      ephemeris_->t_max(),
-      prognosticator_parameters.adaptive_step_parameters,
-      FlightPlan::max_ephemeris_steps_per_frame);
+  // When prolonging the prediction, we may already be past |t_max|.
+  Instant const t_max = ephemeris_->t_max();
+  if (prognosticator_parameters.first_time < t_max) {
+    status = ephemeris_->FlowWithAdaptiveStep(
+        prognostication.get(),
+        Ephemeris<Barycentric>::NoIntrinsicAcceleration,
+        t_max,
+        prognosticator_parameters.adaptive_step_parameters,
+        FlightPlan::max_ephemeris_steps_per_frame);
+  }
   bool const reached_t_max = status.ok();
   if (reached_t_max) {
     // This will prolong the ephemeris by |max_ephemeris_steps_per_frame|.
@@ -613,11 +657,71 @@ Status Vessel::FlowPrognostication(
 
 void Vessel::SwapPrognostication(
     std::unique_ptr<DiscreteTrajectory<Barycentric>>& prognostication,
+    bool const prolongs_prediction,
     Status const& status) {
   prognosticator_lock_.AssertHeld();
   if (status.error() != Error::CANCELLED) {
     prognostication_.swap(prognostication);
+    prognostication_prolongs_prediction_ = prolongs_prediction;
+  }
+}
+
+void Vessel::AttachPrognostication() {
+  prognosticator_lock_.AssertHeld();
+  not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> prognostication =
+      std::move(prognostication_);
+  if (!prognostication_prolongs_prediction_) {
+    psychohistory_->DeleteFork(prediction_);
+    AttachPrediction(std::move(prognostication));
+    prediction_is_stale_ = false;
+    return;
+  }
+
+  // The prediction may have been shortened or replaced since the
+  // prognosticator started, in which case the prolongation is useless.
+  auto const& prediction_back = prediction_->back();
+  auto const& prognostication_front = prognostication->front();
+  if (prediction_back.time != prognostication_front.time ||
+      prediction_back.degrees_of_freedom !=
+          prognostication_front.degrees_of_freedom) {
+    return;
+  }
+  for (auto it = ++prognostication->begin();
+       it != prognostication->end();
+       ++it) {
+    prediction_->Append(it->time, it->degrees_of_freedom);
+  }
+}
+
+bool Vessel::CanProlong(
+    DiscreteTrajectory<Barycentric> const& prediction) const {
+  for (auto const& [_, part] : parts_) {
+    if (part->intrinsic_force() != Vector<Force, Barycentric>()) {
+      return false;
+    }
   }
+
+  auto const& last = psychohistory_->back();
+  if (prediction.Empty() ||
+      last.time < prediction.front().time ||
+      last.time > prediction.back().time) {
+    return false;
+  }
+  DegreesOfFreedom<Barycentric> const predicted_degrees_of_freedom =
+      last.time == prediction.front().time
+          ? prediction.front().degrees_of_freedom
+          : prediction.EvaluateDegreesOfFreedom(last.time);
+
+  // The points of the prediction are far apart, so the error of the
+  // interpolation may exceed the integration tolerances.  Be a bit lenient.
+  constexpr double tolerance_factor = 10;
+  auto const& parameters = prediction_adaptive_step_parameters_;
+  return (predicted_degrees_of_freedom.position() -
+          last.degrees_of_freedom.position()).Norm() <=
+             tolerance_factor * parameters.length_integration_tolerance() &&
+         (predicted_degrees_of_freedom.velocity() -
+          last.degrees_of_freedom.velocity()).Norm() <=
+             tolerance_factor * parameters.speed_integration_tolerance();
 }
 
 void Vessel::AppendToVesselTrajectory(
@@ -678,6 +782,7 @@ void Vessel::AppendToVesselTrajectory(
 
 void Vessel::AttachPrediction(
     not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> trajectory) {
+  prediction_is_prolongable_ = CanProlong(*trajectory);
   trajectory->ForgetBefore(psychohistory_->back().time);
   if (trajectory->Empty()) {
     prediction_ = psychohistory_->NewForkAtLast();
@@ -1,6 +1,8 @@
 ﻿
 #pragma once
 
+#include <atomic>
+#include <cstdint>
 #include <list>
 #include <map>
 #include <memory>
@@ -9,8 +11,9 @@
 #include <vector>
 
 #include "absl/synchronization/mutex.h"
-#include "base/jthread.hpp"
 #include "base/status.hpp"
+#include "base/stoppable_thread_pool.hpp"
+#include "base/work_stealing_thread_pool.hpp"
 #include "ksp_plugin/celestial.hpp"
 #include "ksp_plugin/flight_plan.hpp"
 #include "ksp_plugin/orbit_analyser.hpp"
@@ -28,6 +31,8 @@ namespace internal_vessel {
 
 using base::not_null;
 using base::Status;
+using base::StoppableThreadPool;
+using base::WorkStealingThreadPool;
 using geometry::Instant;
 using geometry::Vector;
 using physics::DegreesOfFreedom;
@@ -46,12 +51,17 @@ class Vessel {
   using Manœuvres = std::vector<
       not_null<std::unique_ptr<Manœuvre<Barycentric, Navigation> const>>>;
 
-  // Constructs a vessel whose parent is initially |*parent|.  No transfer of
+  // Constructs a vessel whose parent is initially |*parent|.  The
+  // prognostications are computed on |prognosticator_pool|, which must outlive
+  // the vessel.  The orbit analyses of the vessel and of its flight plan use
+  // the |analysis_thread_pool|, see |OrbitAnalyser|.  No transfer of
   // ownership.
   Vessel(GUID guid,
          std::string name,
          not_null<Celestial const*> parent,
          not_null<Ephemeris<Barycentric>*> ephemeris,
+         not_null<StoppableThreadPool*> prognosticator_pool,
+         WorkStealingThreadPool* analysis_thread_pool,
          Ephemeris<Barycentric>::AdaptiveStepParameters
              prediction_adaptive_step_parameters);
 
@@ -160,16 +170,24 @@ class Vessel {
 
   // Tries to replace the current prediction with a more recently computed one.
   // No guarantees that this happens.  No guarantees regarding the end time of
-  // the prediction when this call returns.
+  // the prediction when this call returns.  If the vessel is coasting along
+  // the current prediction, the prediction is prolonged instead of being
+  // recomputed.
   virtual void RefreshPrediction();
 
   // Same as above, but when this call returns the prediction is guaranteed to
   // have a last time at or before |time|.
   virtual void RefreshPrediction(Instant const& time);
 
-  // Stop the asynchronous prognosticator as soon as convenient.
+  // Stop the asynchronous prognosticator as soon as convenient.  When this
+  // function returns, no prognostication of this vessel is being computed.
   void StopPrognosticator();
 
+  // When the threads of the prognosticator pool are all busy, the
+  // prognostications of the vessels with the highest priority are computed
+  // first.  The default priority is 0.
+  void set_prognostication_priority(std::int64_t priority);
+
   // Returns "vessel_name (GUID)".
   std::string ShortDebugString() const;
 
@@ -181,6 +199,8 @@ class Vessel {
       serialization::Vessel const& message,
       not_null<Celestial const*> parent,
       not_null<Ephemeris<Barycentric>*> ephemeris,
+      not_null<StoppableThreadPool*> prognosticator_pool,
+      WorkStealingThreadPool* analysis_thread_pool,
       std::function<void(PartId)> const& deletion_callback);
   void FillContainingPileUpsFromMessage(
       serialization::Vessel const& message,
@@ -207,6 +227,9 @@ class Vessel {
     Instant first_time;
     DegreesOfFreedom<Barycentric> first_degrees_of_freedom;
     Ephemeris<Barycentric>::AdaptiveStepParameters adaptive_step_parameters;
+    // If true, the integration starts at the end of the |prediction_| and the
+    // resulting prognostication is appended to it.
+    bool prolongs_prediction;
   };
   friend bool operator!=(PrognosticatorParameters const& left,
                          PrognosticatorParameters const& right);
@@ -214,13 +237,9 @@ class Vessel {
   using TrajectoryIterator =
       DiscreteTrajectory<Barycentric>::Iterator (Part::*)();
 
-  // Starts the |prognosticator_| if it is not started already.  The
-  // |prognosticator_parameters_| must have been set.
-  void StartPrognosticatorIfNeeded() REQUIRES(prognosticator_lock_);
-
-  // Run by the |prognosticator_| thread to periodically recompute the
-  // prognostication.
-  Status RepeatedlyFlowPrognostication();
+  // Run by the |prognosticator_pool_| to compute the prognostication for the
+  // pending |prognosticator_parameters_|, if any.
+  void FlowPendingPrognostication();
 
   // Runs the integrator to compute the |prognostication_| based on the given
   // parameters.
@@ -231,7 +250,19 @@ class Vessel {
   // Publishes the prognostication if the computation was not cancelled.
   void SwapPrognostication(
       std::unique_ptr<DiscreteTrajectory<Barycentric>>& prognostication,
-      Status const& status);
+      bool prolongs_prediction,
+      Status const& status) REQUIRES(prognosticator_lock_);
+
+  // Uses the |prognostication_|, which must not be null, to replace or, if it
+  // was computed for that purpose, to prolong the |prediction_|.
+  void AttachPrognostication() REQUIRES(prognosticator_lock_);
+
+  // Returns true if the vessel is not subject to an intrinsic force and
+  // |prediction|, which must be a root, agrees with the last point of the
+  // |psychohistory_| to within the tolerances of the prediction.  In that case,
+  // the part of |prediction| that lies after the psychohistory is still valid
+  // and only needs to be prolonged.
+  bool CanProlong(DiscreteTrajectory<Barycentric> const& prediction) const;
 
   // Appends to |trajectory| the centre of mass of the trajectories of the parts
   // denoted by |part_trajectory_begin| and |part_trajectory_end|.  Only the
@@ -241,7 +272,7 @@ class Vessel {
                                 DiscreteTrajectory<Barycentric>& trajectory);
 
   // Attaches the given |trajectory| to the end of the |psychohistory_| to
-  // become the new |prediction_|.
+  // become the new |prediction_|, and determines if it can be prolonged.
   void AttachPrediction(
       not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> trajectory);
 
@@ -254,18 +285,23 @@ class Vessel {
   // The parent body for the 2-body approximation.
   not_null<Celestial const*> parent_;
   not_null<Ephemeris<Barycentric>*> const ephemeris_;
+  not_null<StoppableThreadPool*> const prognosticator_pool_;
+  WorkStealingThreadPool* const analysis_thread_pool_ = nullptr;
 
   std::map<PartId, not_null<std::unique_ptr<Part>>> parts_;
   std::set<PartId> kept_parts_;
 
   mutable absl::Mutex prognosticator_lock_;
   // This member only contains a value if |RefreshPrediction| has been called
-  // but the parameters have not been picked by the |prognosticator_|.  It never
+  // but the parameters have not been picked by the prognosticator.  It never
   // contains a moved-from value, and is only read using |std::swap| to ensure
   // that reading it clears it.
   std::optional<PrognosticatorParameters> prognosticator_parameters_
       GUARDED_BY(prognosticator_lock_);
-  base::jthread prognosticator_;
+  std::int64_t prognostication_priority_ = 0;
+  // True if a prognostication may have been scheduled on the
+  // |prognosticator_pool_| since the last call to |StopPrognosticator|.
+  std::atomic_bool prognostication_scheduled_ = false;
 
   // See the comments in pile_up.hpp for an explanation of the terminology.
   not_null<std::unique_ptr<DiscreteTrajectory<Barycentric>>> history_;
@@ -273,11 +309,19 @@ class Vessel {
 
   // The |prediction_| is forked off the end of the |psychohistory_|.
   DiscreteTrajectory<Barycentric>* prediction_ = nullptr;
+  // True if the |prediction_| is consistent with the |psychohistory_| (see
+  // |CanProlong|), in which case |RefreshPrediction| only computes its tail.
+  bool prediction_is_prolongable_ = false;
+  // True if the tolerances of the prediction were changed since the
+  // |prediction_| was computed.
+  bool prediction_is_stale_ = false;
 
   // The |prognostication_| is a root trajectory that's computed asynchronously
   // and may or may not be used as a prediction;
   std::unique_ptr<DiscreteTrajectory<Barycentric>> prognostication_
       GUARDED_BY(prognosticator_lock_);
+  bool prognostication_prolongs_prediction_ GUARDED_BY(prognosticator_lock_) =
+      false;
 
   std::unique_ptr<FlightPlan> flight_plan_;
 
@@ -99,12 +99,16 @@ public enum Style {
         rp2_lines_iterator.IteratorIncrement()) {
       using (DisposableIterator rp2_line_iterator =
           rp2_lines_iterator.IteratorGetRP2LinesIterator()) {
+        // Fetch all the points of the line in a single call.
+        int rp2_line_size = rp2_line_iterator.IteratorSize();
+        if (rp2_points_.Length < rp2_line_size) {
+          rp2_points_ = new XY[rp2_line_size];
+        }
+        int filled = rp2_line_iterator.IteratorGetRP2LineXYs(rp2_points_,
+                                                             rp2_line_size);
         XY? previous_rp2_point = null;
-        for (;
-            !rp2_line_iterator.IteratorAtEnd();
-            rp2_line_iterator.IteratorIncrement()) {
-          XY current_rp2_point = ToScreen(
-              rp2_line_iterator.IteratorGetRP2LineXY());
+        for (int i = 0; i < filled; ++i) {
+          XY current_rp2_point = ToScreen(rp2_points_[i]);
           if (previous_rp2_point.HasValue) {
             if (style == Style.Faded) {
               var faded_colour = colour;
@@ -146,6 +150,10 @@ public enum Style {
     };
   }
 
+  // A buffer reused across calls to |PlotRP2Lines| to receive the points of
+  // a line.
+  private static XY[] rp2_points_ = new XY[0];
+
   private static UnityEngine.Material line_material_;
 
   private static UnityEngine.Material line_material {
@@ -2107,111 +2107,112 @@ select PartCentredForceHolder.
       using (DisposablePlanetarium planetarium =
           GLLines.NewPlanetarium(plugin_, sun_world_position)) {
         GLLines.Draw(() => {
-          PlotCelestialTrajectories(planetarium, main_vessel_guid);
-
-          // Vessel trajectories.
-          if (main_vessel_guid == null) {
-            return;
+          var celestials = CelestialsToPlot();
+          string target_id = null;
+          if (main_vessel_guid != null) {
+            target_id = FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.
+                ToString();
+            if (FlightGlobals.ActiveVessel == null ||
+                plotting_frame_selector_.target_override ||
+                target_id == null ||
+                !plugin_.HasVessel(target_id)) {
+              target_id = null;
+            }
           }
-          // Main vessel psychohistory and prediction.
-          using (DisposableIterator rp2_lines_iterator =
-              planetarium.PlanetariumPlotPsychohistory(
+          int[] celestial_indices =
+              celestials.Select(c => c.Key.flightGlobalsIndex).ToArray();
+          // All the trajectories are plotted in a single call, which returns
+          // them in the order documented in the C++ interface.
+          using (DisposableIterator trajectories =
+              planetarium.PlanetariumPlotTrajectories(
                   plugin_,
                   main_vessel_guid,
+                  target_id,
+                  celestial_indices,
+                  celestial_indices.Length,
                   main_window_.history_length)) {
-            GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                 history_colour,
-                                 history_style);
-          }
-          using (DisposableIterator rp2_lines_iterator =
-              planetarium.PlanetariumPlotPrediction(
-                  plugin_,
-                  main_vessel_guid)) {
-            GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                 prediction_colour,
-                                 prediction_style);
-          }
-          // Target psychohistory and prediction.
-          string target_id = FlightGlobals.fetch.VesselTarget?.GetVessel()?.id.
-              ToString();
-          if (FlightGlobals.ActiveVessel != null &&
-              !plotting_frame_selector_.target_override &&
-              target_id != null &&
-              plugin_.HasVessel(target_id)) {
-            using (DisposableIterator rp2_lines_iterator =
-                planetarium.PlanetariumPlotPsychohistory(
-                    plugin_,
-                    target_id,
-                    main_window_.history_length)) {
-              GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                   target_history_colour,
-                                   target_history_style);
+            // Celestial trajectories.
+            foreach (var celestial in celestials) {
+              PlotNextTrajectory(trajectories,
+                                 celestial.Value,
+                                 GLLines.Style.Faded);
+              PlotNextTrajectory(trajectories,
+                                 celestial.Value,
+                                 GLLines.Style.Solid);
             }
-            using (DisposableIterator rp2_lines_iterator =
-                planetarium.PlanetariumPlotPrediction(
-                    plugin_,
-                    target_id)) {
-              GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                   target_prediction_colour,
-                                   target_prediction_style);
+
+            // Vessel trajectories.
+            if (main_vessel_guid == null) {
+              return;
             }
-          }
-          // Main vessel flight plan.
-          if (plugin_.FlightPlanExists(main_vessel_guid)) {
-            int number_of_anomalous_manœuvres =
-                plugin_.FlightPlanNumberOfAnomalousManoeuvres(main_vessel_guid);
-            int number_of_manœuvres =
-                plugin_.FlightPlanNumberOfManoeuvres(main_vessel_guid);
-            int number_of_segments =
-                plugin_.FlightPlanNumberOfSegments(main_vessel_guid);
-            for (int i = 0; i < number_of_segments; ++i) {
-              bool is_burn = i % 2 == 1;
-              using (DisposableIterator rendered_segments =
-                  plugin_.FlightPlanRenderedSegment(main_vessel_guid,
-                                                    sun_world_position,
-                                                    i)) {
-                if (rendered_segments.IteratorAtEnd()) {
-                  Log.Info("Skipping segment " + i);
-                  continue;
-                }
-                Vector3d position_at_start = (Vector3d)rendered_segments.
-                    IteratorGetDiscreteTrajectoryXYZ();
-                using (DisposableIterator rp2_lines_iterator =
-                    planetarium.PlanetariumPlotFlightPlanSegment(
-                        plugin_,
-                        main_vessel_guid,
-                        i)) {
-                  GLLines.PlotRP2Lines(rp2_lines_iterator,
-                                       is_burn
-                                           ? burn_colour
-                                           : flight_plan_colour,
-                                       is_burn
-                                           ? burn_style
-                                           : flight_plan_style);
-                }
-                if (is_burn) {
-                  int manœuvre_index = i / 2;
-                  if (manœuvre_index <
-                      number_of_manœuvres - number_of_anomalous_manœuvres) {
-                    NavigationManoeuvreFrenetTrihedron manœuvre =
-                        plugin_.FlightPlanGetManoeuvreFrenetTrihedron(
-                            main_vessel_guid,
-                            manœuvre_index);
-                    double scale =
-                        (ScaledSpace.ScaledToLocalSpace(
-                             MapView.MapCamera.transform.position) -
-                         position_at_start).magnitude *
-                        0.015;
-                    Action<XYZ, UnityEngine.Color> add_vector =
-                        (world_direction, colour) => {
-                          UnityEngine.GL.Color(colour);
-                          GLLines.AddSegment(position_at_start,
-                                             position_at_start +
-                                             scale * (Vector3d)world_direction);
-                        };
-                    add_vector(manœuvre.tangent, Style.Tangent);
-                    add_vector(manœuvre.normal, Style.Normal);
-                    add_vector(manœuvre.binormal, Style.Binormal);
+            // Main vessel psychohistory and prediction.
+            PlotNextTrajectory(trajectories, history_colour, history_style);
+            PlotNextTrajectory(trajectories,
+                               prediction_colour,
+                               prediction_style);
+            // Target psychohistory and prediction.
+            if (target_id != null) {
+              PlotNextTrajectory(trajectories,
+                                 target_history_colour,
+                                 target_history_style);
+              PlotNextTrajectory(trajectories,
+                                 target_prediction_colour,
+                                 target_prediction_style);
+            }
+            // Main vessel flight plan.
+            if (plugin_.FlightPlanExists(main_vessel_guid)) {
+              int number_of_anomalous_manœuvres =
+                  plugin_.FlightPlanNumberOfAnomalousManoeuvres(
+                      main_vessel_guid);
+              int number_of_manœuvres =
+                  plugin_.FlightPlanNumberOfManoeuvres(main_vessel_guid);
+              int number_of_segments =
+                  plugin_.FlightPlanNumberOfSegments(main_vessel_guid);
+              for (int i = 0; i < number_of_segments; ++i) {
+                bool is_burn = i % 2 == 1;
+                using (DisposableIterator rendered_segments =
+                    plugin_.FlightPlanRenderedSegment(main_vessel_guid,
+                                                      sun_world_position,
+                                                      i)) {
+                  if (rendered_segments.IteratorAtEnd()) {
+                    Log.Info("Skipping segment " + i);
+                    trajectories.IteratorIncrement();
+                    continue;
+                  }
+                  Vector3d position_at_start = (Vector3d)rendered_segments.
+                      IteratorGetDiscreteTrajectoryXYZ();
+                  PlotNextTrajectory(trajectories,
+                                     is_burn
+                                         ? burn_colour
+                                         : flight_plan_colour,
+                                     is_burn
+                                         ? burn_style
+                                         : flight_plan_style);
+                  if (is_burn) {
+                    int manœuvre_index = i / 2;
+                    if (manœuvre_index <
+                        number_of_manœuvres - number_of_anomalous_manœuvres) {
+                      NavigationManoeuvreFrenetTrihedron manœuvre =
+                          plugin_.FlightPlanGetManoeuvreFrenetTrihedron(
+                              main_vessel_guid,
+                              manœuvre_index);
+                      double scale =
+                          (ScaledSpace.ScaledToLocalSpace(
+                               MapView.MapCamera.transform.position) -
+                           position_at_start).magnitude *
+                          0.015;
+                      Action<XYZ, UnityEngine.Color> add_vector =
+                          (world_direction, colour) => {
+                            UnityEngine.GL.Color(colour);
+                            GLLines.AddSegment(
+                                position_at_start,
+                                position_at_start +
+                                scale * (Vector3d)world_direction);
+                          };
+                      add_vector(manœuvre.tangent, Style.Tangent);
+                      add_vector(manœuvre.normal, Style.Normal);
+                      add_vector(manœuvre.binormal, Style.Binormal);
+                    }
                   }
                 }
               }
@@ -2222,8 +2223,23 @@ select PartCentredForceHolder.
     }
   }
 
-  private void PlotCelestialTrajectories(DisposablePlanetarium planetarium,
-                                         string main_vessel_guid) {
+  // Plots the trajectory denoted by |trajectories| and advances it to the next
+  // one.
+  private static void PlotNextTrajectory(DisposableIterator trajectories,
+                                         UnityEngine.Color colour,
+                                         GLLines.Style style) {
+    using (DisposableIterator rp2_lines_iterator =
+        trajectories.IteratorGetRP2LinesListIterator()) {
+      GLLines.PlotRP2Lines(rp2_lines_iterator, colour, style);
+    }
+    trajectories.IteratorIncrement();
+  }
+
+  // Returns the celestials whose trajectories are visible in the map view, with
+  // the colour of their trajectories.
+  private List<KeyValuePair<CelestialBody, UnityEngine.Color>>
+      CelestialsToPlot() {
+    var celestials = new List<KeyValuePair<CelestialBody, UnityEngine.Color>>();
     foreach (CelestialBody celestial in FlightGlobals.Bodies) {
       if (plotting_frame_selector_.FixedBodies().Contains(celestial)) {
         continue;
@@ -2246,25 +2262,11 @@ select PartCentredForceHolder.
       if (colour.a == 0) {
         continue;
       }
-      using (DisposableIterator rp2_lines_iterator =
-          planetarium.PlanetariumPlotCelestialTrajectoryForPsychohistory(
-              plugin_,
-              celestial.flightGlobalsIndex,
-              main_vessel_guid,
-              main_window_.history_length)) {
-        GLLines.PlotRP2Lines(rp2_lines_iterator, colour, GLLines.Style.Faded);
-      }
-      if (main_vessel_guid != null) {
-        using (DisposableIterator rp2_lines_iterator =
-            planetarium.
-                PlanetariumPlotCelestialTrajectoryForPredictionOrFlightPlan(
-                    plugin_,
-                    celestial.flightGlobalsIndex,
-                    main_vessel_guid)) {
-          GLLines.PlotRP2Lines(rp2_lines_iterator, colour, GLLines.Style.Solid);
-        }
-      }
+      celestials.Add(
+          new KeyValuePair<CelestialBody, UnityEngine.Color>(celestial,
+                                                             colour));
     }
+    return celestials;
   }
 
   private void RenderPredictionMarkers(string vessel_guid,
@@ -148,8 +148,36 @@ void BM_PluginDeserializationBenchmark(benchmark::State& state) {
   state.SetBytesProcessed(bytes_processed);
 }
 
+// Measures only |Plugin::ReadFromMessage|, i.e., the reconstruction of the
+// plugin from a parsed message, excluding the decoding, decompression and
+// parsing done by |principia__DeserializePlugin|.
+void BM_PluginReadFromMessageBenchmark(benchmark::State& state) {
+  char const compressor[] = "gipfeli";
+  char const encoder[] = "hexadecimal";
+  auto const gipfeli_plugin(
+      ReadLinesFromHexadecimalFile(
+          SOLUTION_DIR / "ksp_plugin_test" / "large_plugin.proto.gipfeli.hex"));
+  int bytes_processed = 0;
+  serialization::Plugin message;
+  {
+    auto const plugin = DeserializePluginFromLines(gipfeli_plugin,
+                                                   compressor,
+                                                   encoder,
+                                                   bytes_processed);
+    plugin->WriteToMessage(&message);
+  }
+
+  for (auto _ : state) {
+    auto const plugin = Plugin::ReadFromMessage(message);
+    benchmark::DoNotOptimize(plugin);
+  }
+  state.counters["vessels"] = message.vessel_size();
+  state.SetBytesProcessed(state.iterations() * message.ByteSizeLong());
+}
+
 BENCHMARK(BM_PluginSerializationBenchmark);
 BENCHMARK(BM_PluginDeserializationBenchmark);
+BENCHMARK(BM_PluginReadFromMessageBenchmark);
 BENCHMARK(BM_PluginIntegrationBenchmark);
 
 // .\Release\x64\ksp_plugin_test_tests.exe --gtest_filter=PluginBenchmark.DISABLED_All --gtest_also_run_disabled_tests  // NOLINT
@@ -1,18 +1,25 @@
 
 #include "ksp_plugin/interface.hpp"
 
+#include <vector>
+
 #include "geometry/affine_map.hpp"
 #include "geometry/named_quantities.hpp"
 #include "geometry/orthogonal_map.hpp"
 #include "geometry/permutation.hpp"
 #include "geometry/rotation.hpp"
+#include "geometry/rp2_point.hpp"
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 #include "ksp_plugin/frames.hpp"
 #include "ksp_plugin_test/mock_planetarium.hpp"
 #include "ksp_plugin_test/mock_plugin.hpp"
 #include "ksp_plugin_test/mock_renderer.hpp"
+#include "ksp_plugin_test/mock_vessel.hpp"
+#include "physics/discrete_trajectory.hpp"
+#include "physics/mock_dynamic_frame.hpp"
 #include "quantities/quantities.hpp"
+#include "quantities/si.hpp"
 #include "testing_utilities/actions.hpp"
 
 namespace principia {
@@ -25,19 +32,44 @@ using geometry::OrthogonalMap;
 using geometry::Permutation;
 using geometry::RigidTransformation;
 using geometry::Rotation;
+using geometry::RP2Lines;
+using geometry::RP2Point;
+using geometry::Velocity;
 using ksp_plugin::Camera;
 using ksp_plugin::Navigation;
 using ksp_plugin::MockPlanetarium;
 using ksp_plugin::MockPlugin;
 using ksp_plugin::MockRenderer;
+using ksp_plugin::MockVessel;
+using physics::DegreesOfFreedom;
+using physics::DiscreteTrajectory;
+using physics::MockDynamicFrame;
+using physics::Trajectory;
 using quantities::Length;
+using quantities::si::Metre;
+using quantities::si::Second;
 using testing_utilities::FillUniquePtr;
+using ::testing::ElementsAre;
 using ::testing::IsNull;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::StrictMock;
 using ::testing::_;
 
+namespace {
+
+char const vessel_guid[] = "123-456";
+char const target_vessel_guid[] = "789-012";
+
+MATCHER_P4(IsPlotMethod2Job, trajectory, first_time, last_time, reverse, "") {
+  return arg.trajectory == trajectory &&
+         arg.first_time == first_time &&
+         arg.last_time == last_time &&
+         arg.reverse == reverse;
+}
+
+}  // namespace
+
 class InterfacePlanetariumTest : public ::testing::Test {
  protected:
   InterfacePlanetariumTest()
@@ -78,5 +110,106 @@ TEST_F(InterfacePlanetariumTest, ConstructionDestruction) {
   EXPECT_THAT(planetarium, IsNull());
 }
 
+TEST_F(InterfacePlanetariumTest, PlotTrajectories) {
+  // A psychohistory with points every second from |t0_ - 10 s| to |t0_|, and a
+  // prediction forked from it with points up to |t0_ + 10 s|.  The target has a
+  // shorter prediction.
+  DegreesOfFreedom<Barycentric> const degrees_of_freedom(
+      Barycentric::origin, Velocity<Barycentric>());
+  DiscreteTrajectory<Barycentric> psychohistory;
+  DiscreteTrajectory<Barycentric> target_psychohistory;
+  for (int i = -10; i <= 0; ++i) {
+    psychohistory.Append(t0_ + i * Second, degrees_of_freedom);
+    target_psychohistory.Append(t0_ + i * Second, degrees_of_freedom);
+  }
+  auto const prediction = psychohistory.NewForkAtLast();
+  auto const target_prediction = target_psychohistory.NewForkAtLast();
+  for (int i = 1; i <= 10; ++i) {
+    prediction->Append(t0_ + i * Second, degrees_of_freedom);
+    if (i <= 3) {
+      target_prediction->Append(t0_ + i * Second, degrees_of_freedom);
+    }
+  }
+
+  StrictMock<MockVessel> vessel;
+  StrictMock<MockVessel> target_vessel;
+  MockRenderer renderer;
+  StrictMock<MockDynamicFrame<Barycentric, Navigation>> plotting_frame;
+  StrictMock<MockPlanetarium> planetarium;
+  EXPECT_CALL(*plugin_, GetVessel(vessel_guid))
+      .WillRepeatedly(Return(&vessel));
+  EXPECT_CALL(*plugin_, GetVessel(target_vessel_guid))
+      .WillRepeatedly(Return(&target_vessel));
+  EXPECT_CALL(vessel, psychohistory()).WillRepeatedly(ReturnRef(psychohistory));
+  EXPECT_CALL(vessel, prediction()).WillRepeatedly(ReturnRef(*prediction));
+  EXPECT_CALL(vessel, has_flight_plan()).WillRepeatedly(Return(false));
+  EXPECT_CALL(target_vessel, psychohistory())
+      .WillRepeatedly(ReturnRef(target_psychohistory));
+  EXPECT_CALL(target_vessel, prediction())
+      .WillRepeatedly(ReturnRef(*target_prediction));
+  EXPECT_CALL(*const_plugin_, renderer()).WillRepeatedly(ReturnRef(renderer));
+  EXPECT_CALL(renderer, GetPlottingFrame())
+      .WillRepeatedly(Return(&plotting_frame));
+  EXPECT_CALL(*plugin_, CurrentTime()).WillRepeatedly(Return(t0_));
+  EXPECT_CALL(plotting_frame, t_min())
+      .WillRepeatedly(Return(t0_ - 20 * Second));
+  EXPECT_CALL(plotting_frame, t_max())
+      .WillRepeatedly(Return(t0_ + 8 * Second));
+
+  // All the trajectories are plotted in a single batch, the predictions being
+  // truncated to the range of the plotting frame.
+  RP2Point<Length, Camera> const point(1 * Metre, 2 * Metre, /*z=*/1);
+  EXPECT_CALL(
+      planetarium,
+      PlotMethod2(
+          ElementsAre(
+              IsPlotMethod2Job(static_cast<Trajectory<Barycentric> const*>(
+                                   &psychohistory),
+                               t0_ - 5 * Second,
+                               t0_,
+                               /*reverse=*/true),
+              IsPlotMethod2Job(static_cast<Trajectory<Barycentric> const*>(
+                                   prediction),
+                               t0_,
+                               t0_ + 8 * Second,
+                               /*reverse=*/false),
+              IsPlotMethod2Job(static_cast<Trajectory<Barycentric> const*>(
+                                   &target_psychohistory),
+                               t0_ - 5 * Second,
+                               t0_,
+                               /*reverse=*/true),
+              IsPlotMethod2Job(static_cast<Trajectory<Barycentric> const*>(
+                                   target_prediction),
+                               t0_,
+                               t0_ + 3 * Second,
+                               /*reverse=*/false)),
+          t0_))
+      .WillOnce(Return(std::vector<RP2Lines<Length, Camera>>{
+          {{point, point}},
+          {{point, point}, {point, point, point}},
+          {},
+          {{point, point, point}}}));
+
+  Iterator* trajectories = principia__PlanetariumPlotTrajectories(
+      &planetarium,
+      plugin_.get(),
+      vessel_guid,
+      target_vessel_guid,
+      /*celestial_indices=*/nullptr,
+      /*number_of_celestials=*/0,
+      /*max_history_length=*/5);
+  EXPECT_EQ(4, principia__IteratorSize(trajectories));
+  std::vector<int> sizes;
+  for (; !principia__IteratorAtEnd(trajectories);
+       principia__IteratorIncrement(trajectories)) {
+    Iterator* rp2_lines =
+        principia__IteratorGetRP2LinesListIterator(trajectories);
+    sizes.push_back(principia__IteratorSize(rp2_lines));
+    principia__IteratorDelete(&rp2_lines);
+  }
+  EXPECT_THAT(sizes, ElementsAre(1, 2, 0, 1));
+  principia__IteratorDelete(&trajectories);
+}
+
 }  // namespace interface
 }  // namespace principia
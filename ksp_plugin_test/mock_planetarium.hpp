@@ -2,6 +2,8 @@
 
 #include "ksp_plugin/planetarium.hpp"
 
+#include <vector>
+
 #include "geometry/named_quantities.hpp"
 #include "gmock/gmock.h"
 #include "quantities/si.hpp"
@@ -31,6 +33,11 @@ class MockPlanetarium : public Planetarium {
                 1 * Metre),
             make_not_null<Ephemeris<Barycentric> const*>(),
             make_not_null<NavigationFrame const*>()) {}
+
+  MOCK_CONST_METHOD2(PlotMethod2,
+                     std::vector<RP2Lines<Length, Camera>>(
+                         std::vector<PlotMethod2Job> const& jobs,
+                         Instant const& now));
 };
 
 }  // namespace internal_planetarium
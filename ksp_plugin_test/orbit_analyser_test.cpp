@@ -20,6 +20,7 @@ using astronomy::J2000;
 using astronomy::OrbitRecurrence;
 using astronomy::StandardProduct3;
 using base::not_null;
+using base::WorkStealingThreadPool;
 using geometry::Position;
 using integrators::SymmetricLinearMultistepIntegrator;
 using integrators::methods::QuinlanTremaine1990Order12;
@@ -107,7 +108,10 @@ TEST_F(OrbitAnalyserTest, TinyAnalysis) {
 
 
 TEST_F(OrbitAnalyserTest, TOPEXPoséidon) {
-  OrbitAnalyser analyser(ephemeris_.get(), DefaultHistoryParameters());
+  // The orbital elements are computed in parallel.
+  WorkStealingThreadPool thread_pool(/*pool_size=*/2);
+  OrbitAnalyser analyser(
+      ephemeris_.get(), DefaultHistoryParameters(), &thread_pool);
   EXPECT_THAT(analyser.analysis(), IsNull());
   EXPECT_THAT(analyser.progress_of_next_analysis(), Eq(0));
   auto const& arc =
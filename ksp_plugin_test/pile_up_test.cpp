@@ -2,7 +2,9 @@
 #include "ksp_plugin/pile_up.hpp"
 
 #include <limits>
+#include <list>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -36,6 +38,7 @@ namespace internal_pile_up {
 using base::check_not_null;
 using base::make_not_null_unique;
 using base::Status;
+using base::WorkStealingThreadPool;
 using geometry::AngularVelocity;
 using geometry::Displacement;
 using geometry::NonRotating;
@@ -646,6 +649,194 @@ TEST_F(PileUpTest, MidStepIntrinsicForce) {
       AlmostEquals(old_velocity + 0.5 * fixed_step * a, 1));
 }
 
+// Two pile-ups in free fall are integrated together until one of them is
+// subject to an intrinsic force.
+TEST_F(PileUpTest, Batch) {
+  // Same ephemeris as above.
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  bodies.emplace_back(make_not_null_unique<MassiveBody>(1 * Kilogram));
+  std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+      DegreesOfFreedom<Barycentric>{
+          Barycentric::origin +
+              Displacement<Barycentric>(
+                  {std::pow(2, 100) * Metre, 0 * Metre, 0 * Metre}),
+          Barycentric::unmoving}};
+  Ephemeris<Barycentric> ephemeris{
+      std::move(bodies),
+      initial_state,
+      /*initial_time=*/astronomy::J2000,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Metre,
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<Barycentric>::FixedStepParameters{
+          SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                                Position<Barycentric>>(),
+          1 * Second}};
+
+  EXPECT_CALL(deletion_callback_, Call()).Times(2);
+  TestablePileUp pile_up1({&p1_}, astronomy::J2000,
+                          DefaultPsychohistoryParameters(),
+                          DefaultHistoryParameters(),
+                          &ephemeris,
+                          deletion_callback_.AsStdFunction());
+  TestablePileUp pile_up2({&p2_}, astronomy::J2000,
+                          DefaultPsychohistoryParameters(),
+                          DefaultHistoryParameters(),
+                          &ephemeris,
+                          deletion_callback_.AsStdFunction());
+  std::list<PileUp*> const pile_ups{&pile_up1, &pile_up2};
+  WorkStealingThreadPool thread_pool(/*pool_size=*/2);
+
+  auto batches = PileUp::MakeBatches(pile_ups);
+  EXPECT_THAT(batches, ElementsAre(ElementsAre(&pile_up1, &pile_up2)));
+
+  Time const step = DefaultHistoryParameters().step();
+  Instant const t1 = astronomy::J2000 + 2.5 * step;
+  auto const statuses =
+      PileUp::DeformAndAdvanceTime(batches[0], t1, thread_pool);
+  EXPECT_THAT(statuses, ElementsAre(Status::OK, Status::OK));
+
+  // Both pile-ups got the same fixed steps and were brought to |t1| by their
+  // psychohistory.
+  for (Part* const part : {&p1_, &p2_}) {
+    EXPECT_EQ(astronomy::J2000 + 2 * step, (--part->history_end())->time);
+    EXPECT_EQ(t1, (--part->psychohistory_end())->time);
+  }
+  EXPECT_THAT(
+      p1_.rigid_motion()({RigidPart::origin, RigidPart::unmoving}),
+      Componentwise(AlmostEquals(p1_dof_.position() +
+                                     (t1 - astronomy::J2000) *
+                                         p1_dof_.velocity(),
+                                 0, 20),
+                    AlmostEquals(p1_dof_.velocity(), 0, 20)));
+
+  // The batch is preserved.
+  batches = PileUp::MakeBatches(pile_ups);
+  EXPECT_THAT(batches, ElementsAre(ElementsAre(&pile_up1, &pile_up2)));
+  PileUp::DeformAndAdvanceTime(batches[0], t1 + step, thread_pool);
+
+  // An intrinsic force breaks the batch.
+  p1_.apply_intrinsic_force(
+      p1_.mass() * Vector<Acceleration, Barycentric>(
+                       {1 * Metre / Pow<2>(Second),
+                        0 * Metre / Pow<2>(Second),
+                        0 * Metre / Pow<2>(Second)}));
+  pile_up1.RecomputeFromParts();
+  batches = PileUp::MakeBatches(pile_ups);
+  EXPECT_THAT(batches,
+              ElementsAre(ElementsAre(&pile_up1), ElementsAre(&pile_up2)));
+  for (auto const& batch : batches) {
+    EXPECT_THAT(PileUp::DeformAndAdvanceTime(batch, t1 + 2 * step, thread_pool),
+                ElementsAre(Status::OK));
+  }
+}
+
+// When a batch is broken, its members continue their histories with the state
+// of the batch integrator, and when they are batched again the integration
+// continues with their own integrators: they follow the same trajectory as a
+// pile-up that is never batched.
+TEST_F(PileUpTest, BrokenBatch) {
+  // An ephemeris with a massive body nearby, so that the multistep integrator
+  // has something to remember.
+  std::vector<not_null<std::unique_ptr<MassiveBody const>>> bodies;
+  bodies.emplace_back(make_not_null_unique<MassiveBody>(6e24 * Kilogram));
+  std::vector<DegreesOfFreedom<Barycentric>> initial_state{
+      DegreesOfFreedom<Barycentric>{
+          Barycentric::origin +
+              Displacement<Barycentric>({1e7 * Metre, 0 * Metre, 0 * Metre}),
+          Barycentric::unmoving}};
+  Ephemeris<Barycentric> ephemeris{
+      std::move(bodies),
+      initial_state,
+      /*initial_time=*/astronomy::J2000,
+      /*accuracy_parameters=*/{/*fitting_tolerance=*/1 * Metre,
+                               /*geopotential_tolerance=*/0x1p-24},
+      Ephemeris<Barycentric>::FixedStepParameters{
+          SymplecticRungeKuttaNyströmIntegrator<BlanesMoan2002SRKN6B,
+                                                Position<Barycentric>>(),
+          1 * Second}};
+
+  // |reference| has the same initial state as |p1_| and is never batched.
+  // |p3| is batched with |p1_| after the first batch is broken.
+  Part reference(333,
+                 "reference",
+                 mass1_,
+                 EccentricPart::origin,
+                 inertia_tensor1_,
+                 RigidMotion<EccentricPart, Barycentric>::MakeNonRotatingMotion(
+                     p1_dof_),
+                 /*deletion_callback=*/nullptr);
+  Part p3(444,
+          "p3",
+          mass2_,
+          EccentricPart::origin,
+          inertia_tensor2_,
+          RigidMotion<EccentricPart, Barycentric>::MakeNonRotatingMotion(
+              p2_dof_),
+          /*deletion_callback=*/nullptr);
+
+  EXPECT_CALL(deletion_callback_, Call()).Times(4);
+  auto const make_pile_up = [this, &ephemeris](Part* const part) {
+    return std::make_unique<TestablePileUp>(std::list<not_null<Part*>>{part},
+                                            astronomy::J2000,
+                                            DefaultPsychohistoryParameters(),
+                                            DefaultHistoryParameters(),
+                                            &ephemeris,
+                                            deletion_callback_.AsStdFunction());
+  };
+  auto const pile_up1 = make_pile_up(&p1_);
+  auto pile_up2 = make_pile_up(&p2_);
+  auto const pile_up3 = make_pile_up(&p3);
+  auto const reference_pile_up = make_pile_up(&reference);
+  WorkStealingThreadPool thread_pool(/*pool_size=*/2);
+
+  Time const step = DefaultHistoryParameters().step();
+  Instant t = astronomy::J2000;
+  // Checks that |pile_ups| form a single batch and advances it to |t|.
+  auto const advance = [&t, &thread_pool](std::list<PileUp*> const& pile_ups) {
+    auto const batches = PileUp::MakeBatches(pile_ups);
+    ASSERT_EQ(1, batches.size());
+    EXPECT_EQ(pile_ups.size(), batches[0].size());
+    for (auto const& status :
+         PileUp::DeformAndAdvanceTime(batches[0], t, thread_pool)) {
+      EXPECT_OK(status);
+    }
+  };
+
+  // Long enough for the multistep integrator to be started.
+  for (int i = 0; i < 10; ++i) {
+    t += 2.5 * step;
+    advance({pile_up1.get(), pile_up2.get()});
+    advance({pile_up3.get()});
+    advance({reference_pile_up.get()});
+  }
+
+  // The destruction of |pile_up2| breaks the batch.
+  pile_up2.reset();
+  for (int i = 0; i < 5; ++i) {
+    t += 2.5 * step;
+    advance({pile_up1.get()});
+    advance({pile_up3.get()});
+    advance({reference_pile_up.get()});
+  }
+
+  // |pile_up1| and |pile_up3| are integrated together.
+  for (int i = 0; i < 5; ++i) {
+    t += 2.5 * step;
+    advance({pile_up1.get(), pile_up3.get()});
+    advance({reference_pile_up.get()});
+  }
+
+  EXPECT_EQ(astronomy::J2000 + 50 * step, (--p1_.history_end())->time);
+  EXPECT_EQ(astronomy::J2000 + 50 * step, (--reference.history_end())->time);
+  for (auto it1 = p1_.history_begin(), it = reference.history_begin();
+       it1 != p1_.history_end();
+       ++it1, ++it) {
+    EXPECT_EQ(it->time, it1->time);
+    EXPECT_EQ(it->degrees_of_freedom, it1->degrees_of_freedom)
+        << it1->time - astronomy::J2000;
+  }
+}
+
 TEST_F(PileUpTest, Serialization) {
   MockEphemeris<Barycentric> ephemeris;
   p1_.apply_intrinsic_force(
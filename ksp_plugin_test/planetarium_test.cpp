@@ -71,7 +71,9 @@ using testing_utilities::VanishesBefore;
 using ::testing::_;
 using ::testing::AllOf;
 using ::testing::Ge;
+using ::testing::IsEmpty;
 using ::testing::Le;
+using ::testing::Not;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::SizeIs;
@@ -252,6 +254,51 @@ TEST_F(PlanetariumTest, PlotMethod2) {
 }
 
 #if !defined(_DEBUG)
+// Plotting multiple trajectories in parallel gives the same result as plotting
+// them one by one.
+TEST_F(PlanetariumTest, PlotMethod2Jobs) {
+  auto const discrete_trajectory =
+      NewCircularTrajectory(/*period=*/100'000 * Second,
+                            /*step=*/1 * Second,
+                            /*last=*/25'000 * Second);
+
+  Planetarium::Parameters parameters(
+      /*sphere_radius_multiplier=*/1,
+      /*angular_resolution=*/0.4 * ArcMinute,
+      /*field_of_view=*/90 * Degree);
+  WorkStealingThreadPool thread_pool(/*pool_size=*/2);
+  Planetarium planetarium(
+      parameters, perspective_, &ephemeris_, &plotting_frame_, &thread_pool);
+  Instant const now = t0_ + 10 * Second;
+
+  std::vector<Planetarium::PlotMethod2Job> jobs;
+  for (int i = 0; i < 10; ++i) {
+    jobs.push_back({discrete_trajectory.get(),
+                    /*first_time=*/t0_ + i * 1000 * Second,
+                    /*last_time=*/t0_ + (i + 10) * 1000 * Second,
+                    /*reverse=*/i % 2 == 1});
+  }
+  auto const all_rp2_lines = planetarium.PlotMethod2(jobs, now);
+
+  ASSERT_THAT(all_rp2_lines, SizeIs(jobs.size()));
+  for (int i = 0; i < jobs.size(); ++i) {
+    auto const& job = jobs[i];
+    auto const rp2_lines = planetarium.PlotMethod2(*job.trajectory,
+                                                   job.first_time,
+                                                   job.last_time,
+                                                   now,
+                                                   job.reverse);
+    EXPECT_THAT(rp2_lines, Not(IsEmpty())) << i;
+    ASSERT_THAT(all_rp2_lines[i], SizeIs(rp2_lines.size())) << i;
+    for (int j = 0; j < rp2_lines.size(); ++j) {
+      ASSERT_THAT(all_rp2_lines[i][j], SizeIs(rp2_lines[j].size())) << i;
+      for (int k = 0; k < rp2_lines[j].size(); ++k) {
+        EXPECT_EQ(rp2_lines[j][k], all_rp2_lines[i][j][k]) << i;
+      }
+    }
+  }
+}
+
 TEST_F(PlanetariumTest, RealSolarSystem) {
   auto discrete_trajectory = DiscreteTrajectory<Barycentric>::ReadFromMessage(
       ParseFromBytes<serialization::DiscreteTrajectory>(
@@ -919,6 +919,99 @@ TEST_F(PluginTest, NavballTargetVessel) {
   plugin.NavballFrameField(World::origin)->FromThisFrame(World::origin);
 }
 
+TEST_F(PluginTest, Conjunctions) {
+  Vessel::MakeSynchronous();
+  Plugin plugin(initial_time_,
+                initial_time_,
+                0 * Radian);
+  serialization::GravityModel::Body gravity_model;
+  CHECK(google::protobuf::TextFormat::ParseFromString(
+      R"(name                    : "Sun"
+         gravitational_parameter : "1 m^3/s^2"
+         reference_instant       : "JD2451545.0"
+         mean_radius             : "1 m"
+         axis_right_ascension    : "0 deg"
+         axis_declination        : "90 deg"
+         reference_angle         : "0 deg"
+         angular_frequency       : "1 rad/s")",
+      &gravity_model));
+  plugin.InsertCelestialAbsoluteCartesian(
+      SolarSystemFactory::Sun,
+      /*parent_index=*/std::nullopt,
+      gravity_model,
+      solar_system_->cartesian_initial_state_message(
+          SolarSystemFactory::name(SolarSystemFactory::Sun)));
+  plugin.EndInitialization();
+
+  // The gravity of the Sun is negligible, so the vessels move in straight
+  // lines.  Vessels "b" and "c" pass 50 m from each other 100 s from now.
+  // Vessel "a" is even closer to them, but it doesn't have a prediction.
+  struct VesselState {
+    GUID guid;
+    PartId part_id;
+    Displacement<AliceSun> displacement;
+    Velocity<AliceSun> velocity;
+  };
+  for (auto const& [guid, part_id, displacement, velocity] :
+       {VesselState{"a",
+                    1,
+                    Displacement<AliceSun>(
+                        {0 * Metre, 1e6 * Metre + 20 * Metre, 0 * Metre}),
+                    Velocity<AliceSun>()},
+        VesselState{"b",
+                    2,
+                    Displacement<AliceSun>(
+                        {-1000 * Metre, 1e6 * Metre, 0 * Metre}),
+                    Velocity<AliceSun>(
+                        {10 * Metre / Second, 0 * Metre / Second,
+                         0 * Metre / Second})},
+        VesselState{"c",
+                    3,
+                    Displacement<AliceSun>(
+                        {1000 * Metre, 1e6 * Metre + 50 * Metre, 0 * Metre}),
+                    Velocity<AliceSun>(
+                        {-10 * Metre / Second, 0 * Metre / Second,
+                         0 * Metre / Second})}}) {
+    bool inserted;
+    plugin.InsertOrKeepVessel(guid,
+                              "v" + guid,
+                              SolarSystemFactory::Sun,
+                              /*loaded=*/false,
+                              inserted);
+    plugin.InsertUnloadedPart(
+        part_id,
+        "part",
+        guid,
+        RelativeDegreesOfFreedom<AliceSun>(displacement, velocity));
+  }
+  plugin.PrepareToReportCollisions();
+  plugin.FreeVesselsAndPartsAndCollectPileUps(20 * Milli(Second));
+  plugin.UpdatePrediction({"b", "c"});
+
+  // The prediction of "a" ends at the initial time, before the current time.
+  Instant const t0 = plugin.CurrentTime();
+  plugin.AdvanceTime(t0 + 1 * Second, 0 * Radian);
+  EXPECT_LT(plugin.GetVessel("a")->prediction().t_max(), plugin.CurrentTime());
+  EXPECT_LT(t0 + 1 * Hour, plugin.GetVessel("b")->prediction().t_max());
+  EXPECT_LT(t0 + 1 * Hour, plugin.GetVessel("c")->prediction().t_max());
+
+  auto const conjunctions =
+      plugin.ComputeConjunctions(/*threshold=*/100 * Metre,
+                                 /*horizon=*/1 * Hour);
+  ASSERT_EQ(1, conjunctions.size());
+  EXPECT_EQ("b", conjunctions[0].first_vessel);
+  EXPECT_EQ("c", conjunctions[0].second_vessel);
+  EXPECT_THAT(AbsoluteError(t0 + 100 * Second, conjunctions[0].time),
+              Lt(1 * Milli(Second)));
+  EXPECT_THAT(AbsoluteError(50 * Metre, conjunctions[0].distance),
+              Lt(1 * Milli(Metre)));
+
+  // No conjunction beyond the horizon.
+  EXPECT_THAT(plugin.ComputeConjunctions(/*threshold=*/100 * Metre,
+                                         /*horizon=*/1 * Minute),
+              SizeIs(0));
+}
+
 TEST_F(PluginTest, Frenet) {
   // Create a plugin with planetarium rotation 0.
   Plugin plugin(initial_time_,
@@ -1,10 +1,13 @@
 ﻿
 #include "ksp_plugin/vessel.hpp"
 
+#include <algorithm>
 #include <limits>
 #include <set>
+#include <utility>
 #include <vector>
 
+#include "absl/synchronization/mutex.h"
 #include "astronomy/epoch.hpp"
 #include "base/not_null.hpp"
 #include "base/status.hpp"
@@ -44,15 +47,18 @@ using quantities::MomentOfInertia;
 using quantities::si::Degree;
 using quantities::si::Kilogram;
 using quantities::si::Metre;
+using quantities::si::Newton;
 using quantities::si::Radian;
 using quantities::si::Second;
 using testing_utilities::AlmostEquals;
 using testing_utilities::Componentwise;
 using testing_utilities::EqualsProto;
 using ::testing::AnyNumber;
+using ::testing::Contains;
 using ::testing::DoAll;
 using ::testing::ElementsAre;
 using ::testing::MockFunction;
+using ::testing::Pair;
 using ::testing::Return;
 using ::testing::ReturnRef;
 using ::testing::_;
@@ -75,6 +81,8 @@ class VesselTest : public testing::Test {
                 "vessel",
                 &celestial_,
                 &ephemeris_,
+                &prognosticator_pool_,
+                /*analysis_thread_pool=*/nullptr,
                 DefaultPredictionParameters()) {
     auto p1 = make_not_null_unique<Part>(
         part_id1_,
@@ -99,6 +107,7 @@ class VesselTest : public testing::Test {
   }
 
   MockEphemeris<Barycentric> ephemeris_;
+  StoppableThreadPool prognosticator_pool_{/*pool_size=*/1};
   RotatingBody<Barycentric> const body_;
   Celestial const celestial_;
   PartId const part_id1_ = 111;
@@ -391,6 +400,123 @@ TEST_F(VesselTest, PredictBeyondTheInfinite) {
                                        50.0 * Metre / Second}), 0)));
 }
 
+TEST_F(VesselTest, ProlongPrediction) {
+  // All the trajectories in this test are uniform motions, for which Hermite
+  // interpolation is exact.
+  auto const part_degrees_of_freedom =
+      [](DegreesOfFreedom<Barycentric> const& initial, Instant const& t) {
+        return DegreesOfFreedom<Barycentric>(
+            initial.position() + initial.velocity() * (t - astronomy::J2000),
+            initial.velocity());
+      };
+  auto const vessel_degrees_of_freedom = [this, &part_degrees_of_freedom](
+                                             Instant const& t) {
+    return DegreesOfFreedom<Barycentric>(
+        Barycentric::origin +
+            (mass1_ * (part_degrees_of_freedom(p1_dof_, t).position() -
+                       Barycentric::origin) +
+             mass2_ * (part_degrees_of_freedom(p2_dof_, t).position() -
+                       Barycentric::origin)) / (mass1_ + mass2_),
+        (mass1_ * p1_dof_.velocity() + mass2_ * p2_dof_.velocity()) /
+            (mass1_ + mass2_));
+  };
+  auto const advance_parts = [this, &part_degrees_of_freedom](
+                                 Instant const& t) {
+    p1_->AppendToHistory(t, part_degrees_of_freedom(p1_dof_, t));
+    p2_->AppendToHistory(t, part_degrees_of_freedom(p2_dof_, t));
+  };
+
+  // The prognosticator may run asynchronously, so we record the first time
+  // and the maximum number of steps of the integrations to the infinite
+  // future.
+  absl::Mutex lock;
+  std::vector<std::pair<Instant, std::int64_t>> flows;
+  auto const flow = [&lock, &flows, &vessel_degrees_of_freedom](
+      not_null<DiscreteTrajectory<Barycentric>*> const trajectory,
+      Instant const& t,
+      Ephemeris<Barycentric>::AdaptiveStepParameters const& parameters) {
+    if (t == astronomy::InfiniteFuture) {
+      absl::MutexLock l(&lock);
+      flows.emplace_back(trajectory->front().time, parameters.max_steps());
+    }
+    Instant const t_final = std::min(t, trajectory->back().time + 2 * Second);
+    for (Instant time = trajectory->back().time + 1 * Second;
+         time <= t_final;
+         time += 1 * Second) {
+      trajectory->Append(time, vessel_degrees_of_freedom(time));
+    }
+    return Status::OK;
+  };
+  auto const has_flowed_from = [&lock, &flows](Instant const& t) {
+    absl::MutexLock l(&lock);
+    return std::find_if(flows.begin(),
+                        flows.end(),
+                        [&t](auto const& flow) {
+                          return flow.first == t;
+                        }) != flows.end();
+  };
+
+  EXPECT_CALL(ephemeris_, t_min_locked())
+      .WillRepeatedly(Return(astronomy::J2000));
+  EXPECT_CALL(ephemeris_, t_max())
+      .WillRepeatedly(Return(astronomy::J2000 + 2 * Second));
+  EXPECT_CALL(ephemeris_, FlowWithAdaptiveStep(_, _, _, _, _))
+      .WillRepeatedly([&flow](auto const trajectory,
+                              auto const& intrinsic_acceleration,
+                              Instant const& t,
+                              auto const& parameters,
+                              std::int64_t const max_ephemeris_steps) {
+        return flow(trajectory, t, parameters);
+      });
+
+  // The first prediction is computed from scratch and ends at J2000 + 4 s.
+  vessel_.PrepareHistory(astronomy::J2000);
+  do {
+    vessel_.RefreshPrediction();
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(100ms);
+  } while (vessel_.prediction().back().time != astronomy::J2000 + 4 * Second);
+
+  // The vessel coasts along its prediction, so only the tail of the
+  // prediction is computed.
+  advance_parts(astronomy::J2000 + 1 * Second);
+  vessel_.AdvanceTime();
+  do {
+    vessel_.RefreshPrediction();
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(100ms);
+  } while (vessel_.prediction().back().time != astronomy::J2000 + 6 * Second);
+  {
+    absl::MutexLock l(&lock);
+    EXPECT_THAT(flows,
+                Contains(Pair(astronomy::J2000 + 4 * Second,
+                              DefaultPredictionParameters().max_steps() - 3)));
+  }
+  auto it = vessel_.prediction().Fork();
+  for (Instant t = astronomy::J2000 + 1 * Second;
+       t <= astronomy::J2000 + 6 * Second;
+       t += 1 * Second, ++it) {
+    EXPECT_EQ(t, it->time);
+    EXPECT_THAT(it->degrees_of_freedom,
+                Componentwise(AlmostEquals(
+                                  vessel_degrees_of_freedom(t).position(), 0, 4),
+                              AlmostEquals(
+                                  vessel_degrees_of_freedom(t).velocity(), 0, 4)));
+  }
+  EXPECT_TRUE(it == vessel_.prediction().end());
+
+  // A thrust causes the prediction to be recomputed from scratch.
+  p1_->apply_intrinsic_force(
+      Vector<Force, Barycentric>({1 * Newton, 0 * Newton, 0 * Newton}));
+  advance_parts(astronomy::J2000 + 2 * Second);
+  vessel_.AdvanceTime();
+  do {
+    vessel_.RefreshPrediction();
+    using namespace std::chrono_literals;
+    std::this_thread::sleep_for(100ms);
+  } while (!has_flowed_from(astronomy::J2000 + 2 * Second));
+}
+
 TEST_F(VesselTest, FlightPlan) {
   EXPECT_CALL(ephemeris_, t_max())
       .WillRepeatedly(Return(astronomy::J2000 + 2 * Second));
@@ -460,7 +586,12 @@ TEST_F(VesselTest, SerializationSuccess) {
 
   EXPECT_CALL(ephemeris_, Prolong(_)).Times(2);
   auto const v = Vessel::ReadFromMessage(
-      message, &celestial_, &ephemeris_, /*deletion_callback=*/nullptr);
+      message,
+      &celestial_,
+      &ephemeris_,
+      &prognosticator_pool_,
+      /*analysis_thread_pool=*/nullptr,
+      /*deletion_callback=*/nullptr);
   EXPECT_TRUE(v->has_flight_plan());
 
   serialization::Vessel second_message;